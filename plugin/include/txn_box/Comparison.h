@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <functional>
@@ -27,7 +28,8 @@ class Comparison
 
 public:
   /// Handle type for local instances.
-  using Handle = std::unique_ptr<self_type>;
+  /// Comparisons are placed in the configuration arena, see @c operator @c new.
+  using Handle = std::unique_ptr<self_type, ArenaDestroyer<self_type>>;
 
   /** Factory functor that creates an instance from a configuration node.
    *
@@ -43,8 +45,34 @@ public:
   // Factory that maps from names to assemblers.
   using Factory = std::unordered_map<swoc::TextView, std::tuple<Loader, ActiveType>, std::hash<std::string_view>>;
 
+  /** Quick check to rule out strings that cannot match.
+   *
+   * This is computed at load time from a literal comparison value, so that list comparisons can
+   * skip elements without invoking the comparison.
+   */
+  struct StringFilter {
+    size_t _min = 0;                                  ///< Minimum length.
+    size_t _max = std::numeric_limits<size_t>::max(); ///< Maximum length.
+    int _first  = -1;                                 ///< Required first character, -1 for any.
+    int _last   = -1;                                 ///< Required last character, -1 for any.
+    bool _nc    = false;                              ///< Characters are compared without case.
+
+    /// @return @c false if @a text cannot match, @c true if it might.
+    bool operator()(swoc::TextView const &text) const;
+  };
+
   virtual ~Comparison() = default;
 
+  /** Allocate an instance in the configuration arena of @a cfg.
+   *
+   * @param n Size of the instance.
+   * @param cfg Configuration being loaded.
+   * @return Memory for the instance.
+   *
+   * Instances must be created with @c new (cfg) and are destroyed, but not freed, by @c Handle.
+   */
+  static void *operator new(size_t n, Config &cfg);
+
   /** Number of regular expression capture groups provided by a match.
    *
    * @return The number of capture groups, or 0 if it is not a regular expression.
@@ -54,6 +82,35 @@ public:
    */
   virtual unsigned rxp_group_count() const;
 
+  /** Check if the comparison result depends only on the active feature.
+   *
+   * @return @c true if the same feature value always yields the same result, @c false otherwise.
+   *
+   * This is used to determine if comparison results can be cached across transactions. The default
+   * implementation returns @c false, comparisons that use only literal values and have no side
+   * effects beyond capture and remainder updates should override to return @c true.
+   */
+  virtual bool is_pure() const;
+
+  /** Check if the comparison iterates list features.
+   *
+   * @return @c true if a @c FeatureSequence is handled as a list, @c false otherwise.
+   *
+   * If this returns @c true the active feature may be a @c FeatureSequence in place of a @c TUPLE.
+   * The default implementation returns @c false.
+   */
+  virtual bool accepts_sequence() const;
+
+  /** Get a string prefilter for the comparison.
+   *
+   * @param[out] filter Filter to set.
+   * @return @c true if @a filter was set, @c false if there is no filter.
+   *
+   * If this returns @c true, any @c STRING feature rejected by @a filter must fail the comparison
+   * without side effects. The default implementation returns @c false.
+   */
+  virtual bool string_filter(StringFilter &filter) const;
+
   /// @defgroup Comparison overloads.
   /// These must match the set of types in @c FeatureTypes.
   /// Subclasses (specific comparisons) should override these as appropriate for its supported types.
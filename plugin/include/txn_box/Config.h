@@ -8,6 +8,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <unordered_set>
 #include <vector>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
@@ -22,8 +26,11 @@
 #include "txn_box/Expr.h"
 #include "txn_box/FeatureGroup.h"
 #include "txn_box/Directive.h"
+#include "txn_box/Accelerator.h"
 #include "txn_box/yaml_util.h"
 
+class Rxp;
+
 /// Contains a configuration and configuration helper methods.
 /// This is also used to pass information between node parsing during configuration loading.
 class Config
@@ -251,6 +258,10 @@ public:
    *
    * Strings in the YAML configuration are transient. If the content needs to be available at
    * run time it must be first localized.
+   *
+   * While the configuration is loading, localized text is interned - if identical text has
+   * already been localized that copy is returned. Localized text must therefore not be modified.
+   * The copy is always null terminated, regardless of @a opt.
    */
   std::string_view &localize(std::string_view &text, LocalOpt opt = LOCAL_VIEW);
   swoc::TextView
@@ -307,6 +318,16 @@ public:
    */
   self_type &require_rxp_group_count(unsigned n);
 
+  /** Account for a regular expression used by @a this.
+   *
+   * @param rxp Compiled regular expression.
+   * @return @a this
+   *
+   * This requires capture vectors to support the capture groups in @a rxp, and adds it to the
+   * memory use of @a this.
+   */
+  self_type &require_rxp(Rxp const &rxp);
+
   /** Indicate a directive may be scheduled on a @a hook at runtime.
    *
    * @param hook Runtime dispatch hook.
@@ -340,6 +361,23 @@ public:
    */
   template <typename T> self_type &mark_for_cleanup(T *ptr);
 
+  /** Add a warm up task.
+   *
+   * @param task Functor to invoke during @c warm_up.
+   * @return @a this
+   *
+   * Use this for resources that are bound lazily, so that they are bound before the configuration
+   * handles transactions.
+   */
+  self_type &on_warm_up(std::function<void()> &&task);
+
+  /** Prepare a loaded configuration to handle transactions.
+   *
+   * This invokes the warm up tasks. This should be called after loading and before the
+   * configuration is made active.
+   */
+  void warm_up();
+
   /** Define a directive.
    *
    * @param name Directive name.
@@ -452,6 +490,48 @@ public:
    */
   Directive::CfgStaticData const *drtv_info(swoc::TextView const &name) const;
 
+  /// Counts of configuration elements, for analysis.
+  struct ElementCounts {
+    using HookCounts = std::array<unsigned, std::tuple_size<Hook>::value>;
+    HookCounts _directives{};              ///< Directives, by hook.
+    HookCounts _comparisons{};             ///< Comparisons, by hook.
+    HookCounts _rxps{};                    ///< Compiled regular expressions, by hook.
+    unsigned _pure_comparisons = 0;        ///< Comparisons that depend only on the active feature.
+    Accelerator::Counters _accelerators{}; ///< Accelerator candidate comparisons.
+  };
+
+  /// @return Counts of the elements loaded in to @a this.
+  ElementCounts const &
+  element_counts() const
+  {
+    return _element_counts;
+  }
+
+  /** Account for a comparison loaded for @a this.
+   *
+   * @param cmp Comparison.
+   * @return @a this
+   */
+  self_type &count_comparison(Comparison const &cmp);
+
+  /// @return The number of regular expression capture groups required.
+  unsigned
+  capture_group_count() const
+  {
+    return _capture_groups;
+  }
+
+  /// Path and load time of a configuration file.
+  using FileLoadTimes = std::vector<std::pair<swoc::file::path, std::chrono::nanoseconds>>;
+
+  /// @return The path and load time of each configuration file loaded.
+  /// @note This is available only after the configuration has been loaded.
+  FileLoadTimes const &
+  file_load_times() const
+  {
+    return _file_load_times;
+  }
+
   /// @return Number of files loaded for this configuration.
   size_t
   file_count() const
@@ -459,6 +539,28 @@ public:
     return _cfg_file_count;
   }
 
+  /// @return The generation of this configuration - later configurations have larger values.
+  unsigned
+  generation() const
+  {
+    return _generation;
+  }
+
+  /// Memory use by a configuration.
+  struct MemoryInfo {
+    size_t _arena_allocated = 0; ///< Bytes allocated from the configuration arena.
+    size_t _arena_reserved  = 0; ///< Bytes in all configuration arena blocks.
+    size_t _directive_count = 0; ///< Number of directives.
+    size_t _rxp_count       = 0; ///< Number of compiled regular expressions.
+    size_t _rxp_bytes       = 0; ///< Bytes in compiled regular expressions.
+    size_t _text_count      = 0; ///< Number of localized strings.
+    size_t _text_bytes      = 0; ///< Bytes in localized strings.
+    size_t _text_stored     = 0; ///< Bytes used to store localized strings, after interning.
+  };
+
+  /// @return The memory use of @a this.
+  MemoryInfo memory_info() const;
+
   /// @return The total amount of context storage reserved.
   size_t
   reserved_ctx_storage_size() const
@@ -503,6 +605,22 @@ protected:
   /// Always at least one because literal matches use that.
   unsigned _capture_groups = 1;
 
+  /// Number of compiled regular expressions, for memory accounting.
+  size_t _rxp_count = 0;
+  /// Bytes in compiled regular expressions, for memory accounting.
+  size_t _rxp_bytes = 0;
+
+  /// Element counts for analysis.
+  ElementCounts _element_counts;
+
+  /// Localized text, for interning. Used only while loading.
+  std::unordered_set<std::string_view> _interned;
+  /// Set if localized text is interned - cleared when loading is done.
+  bool _intern_p = true;
+  size_t _text_count  = 0; ///< Number of localized strings.
+  size_t _text_bytes  = 0; ///< Bytes in localized strings.
+  size_t _text_stored = 0; ///< Bytes used to store localized strings.
+
   /** @defgroup Feature reference tracking.
    * A bit obscure but necessary because the active feature and the active capture groups must
    * be tracked independently because either can be overwritten independent of the other. When
@@ -557,6 +675,9 @@ protected:
   /// Additional clean up to perform when @a this is destroyed.
   swoc::IntrusiveDList<Finalizer::Linkage> _finalizers;
 
+  /// Tasks for @c warm_up.
+  std::vector<std::function<void()>> _warm_up_tasks;
+
   /** Load a directive.
    *
    * @param drtv_node Node containing the directive.
@@ -632,6 +753,9 @@ protected:
      */
     void add_cfg_key(swoc::TextView key);
 
+    /// Time spent loading this file, across all root keys, including files it loads.
+    std::chrono::nanoseconds _load_time{0};
+
   protected:
     std::list<std::string> _keys; ///< Root keys loaded from this file.
   };
@@ -643,6 +767,13 @@ protected:
   /// # of configuration files tracked.
   /// Used for diagnostics.
   size_t _cfg_file_count = 0;
+  /// Load time of the configuration files, kept after @a _cfg_files is cleared.
+  FileLoadTimes _file_load_times;
+
+  /// Number of configurations created, for @a _generation.
+  static inline std::atomic<unsigned> _generation_count{0};
+  /// Generation of this configuration.
+  unsigned _generation = ++_generation_count;
 };
 
 inline bool
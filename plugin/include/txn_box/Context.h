@@ -96,6 +96,19 @@ public:
    */
   Feature extract(Expr const &expr);
 
+  /** Extract a feature for iteration.
+   *
+   * @param expr The feature expression.
+   * @return The feature.
+   *
+   * This is the same as @c extract except that if @a expr is a single extractor without
+   * modifiers, a list value may be returned as a @c FeatureSequence instead of a @c TUPLE. The
+   * result should only be used with @c car, @c cdr, or @c for_each_element.
+   *
+   * @see Extractor::extract_sequence
+   */
+  Feature extract_sequence(Expr const &expr);
+
   enum ViewOption {
     EX_COMMIT, ///< Force transient to be committed
     EX_C_STR   ///< Force C-string (null terminated)
@@ -234,6 +247,45 @@ public:
   }
 #endif
 
+  /// @return The number of bytes allocated from the context arena.
+  size_t
+  arena_size() const
+  {
+    return _arena->size();
+  }
+
+  /// Memory use by a context.
+  struct MemoryInfo {
+    size_t _arena_allocated        = 0; ///< Bytes allocated from the arena.
+    size_t _arena_reserved         = 0; ///< Bytes in all arena blocks.
+    size_t _arena_initial          = 0; ///< Bytes in the initial arena block.
+    unsigned _transient_grow_count = 0; ///< Transient buffer requests that needed a new block.
+    size_t _transient_grow_bytes   = 0; ///< Bytes requested by those transient buffer requests.
+    unsigned _finalizer_count      = 0; ///< Number of finalizers.
+    unsigned _overflow_count       = 0; ///< Number of overflow reserved spans.
+    size_t _overflow_bytes         = 0; ///< Bytes in overflow reserved spans.
+    size_t _rxp_bytes              = 0; ///< Bytes allocated for regular expression match data.
+  };
+
+  /// @return The current memory use of @a this.
+  MemoryInfo memory_info() const;
+
+  /** Define the statistics for context memory use.
+   *
+   * @return Errors, if any.
+   *
+   * The memory use of each context is added to these statistics when the context is destroyed.
+   * If this is not called, memory use is not recorded.
+   */
+  static swoc::Errata memory_stats_define();
+
+  /** Print the context memory statistics.
+   *
+   * @param w Output.
+   * @return @a w
+   */
+  static swoc::BufferWriter &memory_stats_print(swoc::BufferWriter &w);
+
   /** Convert a reserved span into memory in @a this.
    *
    * @param span Reserve span.
@@ -254,7 +306,6 @@ public:
   template <typename T> swoc::MemSpan<T> initialized_storage_for(ReservedSpan const &span);
 
   Hook _cur_hook   = Hook::INVALID;
-  TSCont _cont     = nullptr;
   ts::HttpTxn _txn = nullptr;
 
   /// Current extracted feature.
@@ -554,6 +605,9 @@ protected:
   /// List of overflaw reserved spans.
   swoc::IntrusiveDList<OverflowSpan::Linkage> _overflow_spans;
 
+  /// Memory accounting. The arena values are computed on demand, not stored here.
+  MemoryInfo _mem;
+
   /// A transaction scope variable.
   struct TxnVar {
     using self_type = TxnVar; ///< Self reference type.
@@ -597,6 +651,9 @@ protected:
 
   swoc::MemSpan<void> overflow_storage_for(ReservedSpan const &span);
 
+  /// Update memory accounting if a transient request for @a n bytes requires a new arena block.
+  void transient_grow_check(size_t n);
+
   /// Used for generating transient feature expression values.
   std::optional<swoc::FixedBufferWriter> _transient_writer;
 
@@ -604,12 +661,21 @@ protected:
    *
    * @param cont TS Continuation.
    * @param evt Event type.
-   * @param payload Ignored.
+   * @param payload Transaction.
    * @return 0
    *
-   * The @c Context instance is carried as the Continuation data.
+   * The @c Context instance is carried in the transaction argument @c G.TxnArgIdx.
    */
   static int ts_callback(TSCont cont, TSEvent evt, void *payload);
+
+  /** Continuation for transaction hooks.
+   *
+   * @return The continuation.
+   *
+   * This is shared by all transactions so that a continuation is not created and destroyed for
+   * every transaction. It has no mutex, the hooks are called with the transaction mutex held.
+   */
+  static TSCont txn_cont();
 };
 
 // --- Implementation ---
@@ -626,6 +692,7 @@ Context::mark_for_cleanup(T *ptr)
 {
   auto f = _arena->make<Finalizer>(ptr, [](void *ptr) { std::destroy_at(static_cast<T *>(ptr)); });
   _finalizers.append(f);
+  ++_mem._finalizer_count;
   return *this;
 }
 
@@ -633,7 +700,8 @@ template <typename T>
 Context &
 Context::mark_for_cleanup(T* ptr, void (*cleaner)(T*))
 {
-  _finalizers.append(_arena->make<Finalizer>(ptr, cleaner));
+  _finalizers.append(_arena->make<Finalizer>(ptr, [cleaner](void *ptr) { cleaner(static_cast<T *>(ptr)); }));
+  ++_mem._finalizer_count;
   return *this;
 }
 
@@ -36,7 +36,8 @@ public:
   static constexpr swoc::TextView DO_KEY = Global::DO_KEY;
 
   /// Generic handle for all directives.
-  using Handle = std::unique_ptr<self_type>;
+  /// Directives are placed in the configuration arena, see @c operator @c new.
+  using Handle = std::unique_ptr<self_type, ArenaDestroyer<self_type>>;
 
   /** Functor to create an instance of a @c Directive from configuration.
    *
@@ -96,6 +97,16 @@ public:
 
   virtual ~Directive() = default;
 
+  /** Allocate an instance in the configuration arena of @a cfg.
+   *
+   * @param n Size of the instance.
+   * @param cfg Configuration being loaded.
+   * @return Memory for the instance.
+   *
+   * Instances must be created with @c new (cfg) and are destroyed, but not freed, by @c Handle.
+   */
+  static void *operator new(size_t n, Config &cfg);
+
   /** Invoke the directive.
    *
    * @param ctx The transaction context.
@@ -93,6 +93,21 @@ public:
    */
   virtual Feature extract(Context &ctx, Spec const &spec) = 0;
 
+  /** Extract the feature from the @a ctx as a sequence if possible.
+   *
+   * @param ctx Runtime context.
+   * @param spec Specifier for the extractor.
+   * @return The extracted feature.
+   *
+   * This is used where the feature will only be iterated, such as by @c for-each. An extractor
+   * that would return a @c TUPLE can instead return a @c FeatureSequence to generate the elements
+   * on demand. The sequence is allocated in @a ctx and, if it needs destruction, marked for cleanup
+   * there. The base implementation calls @c extract.
+   *
+   * @see FeatureSequence
+   */
+  virtual Feature extract_sequence(Context &ctx, Spec const &spec);
+
   /** Extract from the configuration.
    *
    * @param cfg Configuration.
@@ -25,7 +25,8 @@ class Modifier
 
 public:
   /// Handle for instances.
-  using Handle = std::unique_ptr<self_type>;
+  /// Modifiers are placed in the configuration arena, see @c operator @c new.
+  using Handle = std::unique_ptr<self_type, ArenaDestroyer<self_type>>;
 
   /** Function to create an instance from YAML configuration.
    * @param cfg The configuration state object.
@@ -40,6 +41,16 @@ public:
 
   virtual ~Modifier() = default;
 
+  /** Allocate an instance in the configuration arena of @a cfg.
+   *
+   * @param n Size of the instance.
+   * @param cfg Configuration being loaded.
+   * @return Memory for the instance.
+   *
+   * Instances must be created with @c new (cfg) and are destroyed, but not freed, by @c Handle.
+   */
+  static void *operator new(size_t n, Config &cfg);
+
   /** Modification operator.
    *
    * @param ctx Runtime transaction context.
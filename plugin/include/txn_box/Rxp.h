@@ -63,6 +63,9 @@ public:
   /// @return The number of capture groups in the expression.
   size_t capture_count() const;
 
+  /// @return The size in bytes of the compiled expression.
+  size_t size() const;
+
   /// Regular expression options.
   union Options {
     unsigned int all; ///< All of the flags.
@@ -0,0 +1,113 @@
+/** @file
+ * Bounded LRU cache for use from multiple threads.
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <swoc/TextView.h>
+
+#include "txn_box/common.h"
+
+/** Bounded LRU cache of string keys to values of type @a V.
+ *
+ * The cache is split in to independently locked shards to reduce contention. Each shard holds at
+ * most its share of the total size, and evicts its least recently used entry when full.
+ *
+ * @tparam V Value type.
+ */
+template <typename V> class ShardedLRU
+{
+  using self_type = ShardedLRU; ///< Self reference type.
+public:
+  static constexpr size_t N_SHARDS = 16; ///< Number of shards.
+
+  /// Construct with a limit of @a size entries.
+  explicit ShardedLRU(size_t size) : _limit(std::max<size_t>(1, size / N_SHARDS)) {}
+
+  /** Look up @a key.
+   *
+   * @param key Key to find.
+   * @param f Functor invoked as @c bool(V &) on the value, with the shard locked.
+   * @return @c true if @a key was found and @a f returned @c true.
+   *
+   * If @a f returns @c true the entry is made most recently used, otherwise it is removed.
+   */
+  template <typename F> bool find(swoc::TextView key, F &&f);
+
+  /** Cache @a value for @a key.
+   *
+   * @param key Key for @a value.
+   * @param value Value to cache.
+   *
+   * If @a key is already present, from another thread getting there first, its value is replaced.
+   */
+  void insert(swoc::TextView key, V &&value);
+
+protected:
+  using Entry = std::pair<std::string, V>;
+  using LRU   = std::list<Entry>; ///< Most recently used at the front.
+
+  struct Shard {
+    std::mutex _mutex;
+    LRU _lru;
+    std::unordered_map<std::string_view, typename LRU::iterator, std::hash<std::string_view>> _map;
+  };
+
+  size_t _limit; ///< Maximum entries per shard.
+  std::array<Shard, N_SHARDS> _shards;
+
+  Shard &
+  shard_for(swoc::TextView key)
+  {
+    return _shards[Hash64FNV1a(key) % N_SHARDS];
+  }
+};
+
+template <typename V>
+template <typename F>
+bool
+ShardedLRU<V>::find(swoc::TextView key, F &&f)
+{
+  auto &shard = this->shard_for(key);
+  std::lock_guard lock(shard._mutex);
+  if (auto spot = shard._map.find(key); spot != shard._map.end()) {
+    auto item = spot->second;
+    if (!f(item->second)) {
+      shard._map.erase(spot);
+      shard._lru.erase(item);
+      return false;
+    }
+    shard._lru.splice(shard._lru.begin(), shard._lru, item);
+    return true;
+  }
+  return false;
+}
+
+template <typename V>
+void
+ShardedLRU<V>::insert(swoc::TextView key, V &&value)
+{
+  auto &shard = this->shard_for(key);
+  std::lock_guard lock(shard._mutex);
+  if (auto spot = shard._map.find(key); spot != shard._map.end()) {
+    spot->second->second = std::move(value); // Another thread got here first.
+    return;
+  }
+  if (shard._lru.size() >= _limit) {
+    shard._map.erase(shard._lru.back().first);
+    shard._lru.pop_back();
+  }
+  shard._lru.emplace_front(std::string{key}, std::move(value));
+  shard._map.emplace(shard._lru.front().first, shard._lru.begin());
+}
@@ -0,0 +1,72 @@
+/** @file
+ * Plugin statistic reference support.
+ *
+ * Copyright 2020, Oath Inc.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <swoc/TextView.h>
+
+#include "txn_box/common.h"
+#include "txn_box/ts_util.h"
+
+/// Statistic information.
+/// The name is used when it can't be resolved during configuration loading.
+struct Stat {
+  static constexpr int UNRESOLVED = -1;
+  static constexpr int INVALID    = -2;
+  swoc::TextView _name;  ///< Statistic name.
+  int _idx = UNRESOLVED; ///< Statistic index.
+
+  Stat() = default;
+  Stat(Config &cfg, swoc::TextView const &name) { this->assign(cfg, name); }
+
+  /** Set the statistic by name.
+   *
+   * @param cfg Configuration instance.
+   * @param name Name of the statistic in the configuration.
+   * @return @a this
+   *
+   * If the statistic has already been defined the index is resolved immediately, otherwise
+   * resolution is deferred to first use.
+   */
+  Stat &assign(Config &cfg, swoc::TextView name);
+
+  /// @return @c true if a statistic name has been set.
+  bool
+  is_set() const
+  {
+    return !_name.empty();
+  }
+
+  int
+  index()
+  {
+    if (_idx == UNRESOLVED) {
+      _idx = ts::plugin_stat_index(_name);
+      if (_idx < 0) { // On a lookup failure, give up and prevent future lookups.
+        _idx = INVALID;
+      }
+    }
+    return _idx;
+  }
+
+  Feature
+  value()
+  {
+    auto n{this->index()};
+    return n < 0 ? NIL_FEATURE : feature_type_for<INTEGER>{ts::plugin_stat_value(_idx)};
+  }
+
+  Stat &
+  update(feature_type_for<INTEGER> value)
+  {
+    auto n{this->index()};
+    if (n >= 0) {
+      ts::plugin_stat_update(n, value);
+    }
+    return *this;
+  }
+};
@@ -11,6 +11,7 @@
 #include <variant>
 #include <chrono>
 #include <functional>
+#include <memory>
 
 #include <swoc/swoc_meta.h>
 #include <swoc/TextView.h>
@@ -85,6 +86,7 @@ static constexpr swoc::TextView DURATION_TAG{"!duration"};
 // Self referential types, forward declared.
 struct Cons;
 struct Feature;
+class FeatureSequence;
 
 /// Compact tuple representation, via a @c Memspan.
 /// Tuples have a fixed size.
@@ -123,6 +125,54 @@ public:
   {
     return false;
   }
+
+  /// @return @a this as a sequence, or @c nullptr if it is not a sequence.
+  virtual FeatureSequence *
+  as_sequence()
+  {
+    return nullptr;
+  }
+};
+
+/** A sequence of features generated on demand.
+ *
+ * This is used in place of a @c TUPLE when the elements can be generated one at a time from the
+ * source, so that iteration does not require copying every element first and stopping early does
+ * not generate unused elements. The sequence is a cursor - @c extract is the current element and
+ * @c next moves to the next element. Because of this, copies of a feature containing a sequence
+ * share the iteration state.
+ *
+ * @see for_each_element
+ */
+class FeatureSequence : public Generic
+{
+  using self_type  = FeatureSequence; ///< Self reference type.
+  using super_type = Generic;         ///< Parent type.
+public:
+  static constexpr swoc::TextView TAG{"sequence"};
+
+  FeatureSequence() : super_type(TAG) {}
+
+  /// @return The current element, or @c NIL_FEATURE if there are no more elements.
+  Feature extract() const override = 0;
+
+  /// @return @c true if there are no more elements.
+  bool is_nil() const override = 0;
+
+  /** Move to the next element.
+   *
+   * @return @c true if there is a current element after the move, @c false if not.
+   */
+  virtual bool next() = 0;
+
+  /// Move back to the first element.
+  virtual void rewind() = 0;
+
+  self_type *
+  as_sequence() override
+  {
+    return this;
+  }
 };
 
 /// Enumeration of types of values, e.g. those returned by a feature string or extractor.
@@ -326,6 +376,10 @@ struct Feature : public FeatureTypeList::template apply<std::variant> {
   self_type join(Context &ctx, swoc::TextView const &glue) const;
 };
 
+// Features are copied by value everywhere and tuples are arrays of them, so size matters. The largest
+// members are @c FeatureView and @c swoc::IPAddr, 24 bytes each, plus the variant index.
+static_assert(sizeof(Feature) <= 32, "Feature has grown - check copy and tuple costs with bench_txn_box.");
+
 bool operator==(Feature const &lhs, Feature const &rhs);
 inline bool
 operator!=(Feature const &lhs, Feature const &rhs)
@@ -707,18 +761,62 @@ Feature car(Feature const &feature);
  * @return If @a feature is not a sequence, or there are no more elements in @a feature, the @c NIL feature.
  * Otherwise a sequence not containing the first element of @a feature.
  *
+ * @note A @c FeatureSequence is advanced in place and left in @a feature, which is then nil once
+ * there are no more elements.
  */
 Feature &cdr(Feature &feature);
 
+/** Clear @a feature.
+ *
+ * @param feature Feature to clear.
+ *
+ * A @c FeatureSequence is not destroyed, it is owned by the context that created it and may be
+ * shared by copies of @a feature.
+ */
 inline void
 clear(Feature &feature)
 {
-  if (auto gf = std::get_if<GENERIC>(&feature); gf) {
+  if (auto gf = std::get_if<GENERIC>(&feature); gf && *gf && nullptr == (*gf)->as_sequence()) {
     (*gf)->~Generic();
   }
   feature = NIL_FEATURE;
 }
 
+/** Invoke @a f on each element of @a feature.
+ *
+ * @param feature Feature to iterate.
+ * @param f Functor invoked as @c bool(Feature const&) for each element, iteration stops if it
+ * returns @c false.
+ * @return @c true if @a f was invoked on every element, @c false if iteration was stopped.
+ *
+ * Tuples and sequences are iterated, any other feature is treated as a single element. A
+ * sequence is rewound before iterating and only generates elements as far as @a f requests.
+ */
+template <typename F>
+bool
+for_each_element(Feature const &feature, F &&f)
+{
+  if (auto t = std::get_if<IndexFor(TUPLE)>(&feature); t) {
+    for (auto const &item : *t) {
+      if (!f(item)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (auto gf = std::get_if<IndexFor(GENERIC)>(&feature); gf && *gf) {
+    if (auto seq = (*gf)->as_sequence(); seq) {
+      for (seq->rewind(); !seq->is_nil(); seq->next()) {
+        if (!f(seq->extract())) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+  return f(feature);
+}
+
 static constexpr swoc::TextView ACTIVE_FEATURE_KEY{"..."};
 static constexpr swoc::TextView UNMATCHED_FEATURE_KEY{"*"};
 
@@ -886,6 +984,84 @@ struct ReservedSpan {
   size_t n      = 0; ///< Storage size;
 };
 
+/** Stable 64 bit hash of @a text.
+ *
+ * @param text Text to hash.
+ * @param seed Initial hash state, to create independent hashes of the same text.
+ * @return The hash value.
+ *
+ * This is FNV-1a, which, unlike @c std::hash, yields the same value in every build and platform.
+ * Use this for anything that must be consistent across processes or restarts.
+ */
+inline uint64_t
+Hash64FNV1a(swoc::TextView text, uint64_t seed = 0xcbf29ce484222325ULL)
+{
+  for (auto c : text) {
+    seed = (seed ^ uint8_t(c)) * 0x100000001b3ULL;
+  }
+  return seed;
+}
+
+/** Stable fast 64 bit hash of @a text.
+ *
+ * @param text Text to hash.
+ * @param seed Seed, to create independent hashes of the same text.
+ * @return The hash value.
+ *
+ * This is wyhash (final version 4). It consumes 16 bytes per step with 128 bit multiplies and so is
+ * much faster than @c Hash64FNV1a on longer text. The value is the same on every build and
+ * platform.
+ */
+uint64_t Hash64Wy(swoc::TextView text, uint64_t seed = 0);
+
+/** Size of the base64 encoding of @a n bytes.
+ *
+ * @param n Number of bytes to encode.
+ * @param url_p Use base64url, which is not padded.
+ * @return The number of characters in the encoding.
+ */
+constexpr size_t
+base64_encoded_size(size_t n, bool url_p = false)
+{
+  return url_p ? (n * 4 + 2) / 3 : ((n + 2) / 3) * 4;
+}
+
+/** Encode @a src as base64.
+ *
+ * @param dst Output buffer, at least @c base64_encoded_size bytes.
+ * @param src Bytes to encode.
+ * @param url_p Use the base64url alphabet without padding.
+ * @return The number of characters written.
+ */
+size_t base64_encode(swoc::MemSpan<char> dst, swoc::TextView src, bool url_p = false);
+
+/** Size of the decoding of base64 text.
+ *
+ * @param src Encoded text.
+ * @return The exact decoded size if @a src is valid, or a negative value if the length is not valid.
+ *
+ * Trailing padding is ignored. The characters are not checked.
+ */
+ssize_t base64_decoded_size(swoc::TextView src);
+
+/** Decode base64 text.
+ *
+ * @param dst Output buffer, at least @c base64_decoded_size bytes.
+ * @param src Encoded text, in either the standard or the url alphabet. Padding is permitted but not required.
+ * @return The decoded size, or a negative value if @a src is not valid.
+ */
+ssize_t base64_decode(swoc::MemSpan<char> dst, swoc::TextView src);
+
+/** Write @a text as a JSON string.
+ *
+ * @param w Output.
+ * @param text Text to write.
+ * @return @a w
+ *
+ * The text is quoted, and quotes, backslashes and control characters are escaped.
+ */
+swoc::BufferWriter &json_string(swoc::BufferWriter &w, swoc::TextView text);
+
 /// Used for clean up in @c Config and @c Context.
 /// A list of these is used to perform additional cleanup for extensions to the basic object.
 struct Finalizer {
@@ -902,6 +1078,26 @@ struct Finalizer {
 
 inline Finalizer::Finalizer(void *ptr, std::function<void(void *)> &&f) : _ptr(ptr), _f(std::move(f)) {}
 
+/** Deleter for objects placed in a configuration arena.
+ *
+ * @tparam T Type of object.
+ *
+ * The object is destroyed but not freed - the memory is released when the arena is destroyed.
+ * This is used for the handles of configuration elements (directives, comparisons, modifiers)
+ * so that elements loaded together are placed together in memory.
+ */
+template <typename T> struct ArenaDestroyer {
+  ArenaDestroyer() = default;
+  /// Allow handles for derived types to convert to handles for base types.
+  template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>> ArenaDestroyer(ArenaDestroyer<U> const &) {}
+
+  void
+  operator()(T *t) const
+  {
+    std::destroy_at(t);
+  }
+};
+
 /** Scoping value change.
  *
  * @tparam T Type of variable to scope.
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <type_traits>
 #include <variant>
 
@@ -650,6 +651,16 @@ public:
    */
   bool set_upstream_addr(swoc::IPAddr const &addr) const;
 
+  /** Fix the upstream address and port.
+   *
+   * @param addr Endpoint to use for the upstream.
+   * @return @c true if successful, @c false if not.
+   */
+  bool set_upstream_addr(swoc::IPEndpoint const &addr) const;
+
+  /// @return The state of the upstream connection.
+  TSServerState upstream_state() const;
+
   /** Assign @a n to the integer transaction overridable configuration @a var
    *
    * @param var Overridable variable.
@@ -827,12 +838,29 @@ int ssl_nid(swoc::TextView const &name);
  */
 int plugin_stat_index(swoc::TextView const &name);
 
-int plugin_stat_value(int idx);
+intmax_t plugin_stat_value(int idx);
 
 void plugin_stat_update(int idx, intmax_t value);
 
+/** Set the value of a stat.
+ *
+ * @param idx Stat index.
+ * @param value New value.
+ *
+ * This is for gauges, counters should use @c plugin_stat_update.
+ */
+void plugin_stat_set(int idx, intmax_t value);
+
 swoc::Rv<int> plugin_stat_define(swoc::TextView const &name, int value, bool persistent_p);
 
+/** Visit every plugin stat.
+ *
+ * @param f Functor called with the name and value of each stat.
+ *
+ * This takes the record locks and so should not be called on a transaction thread.
+ */
+void plugin_stat_dump(std::function<void(swoc::TextView name, intmax_t value)> const &f);
+
 /** Generate a NOTE log entry.
  *
  * @param text Text of the NOTE.
@@ -1004,6 +1032,14 @@ const swoc::TextView HTTP_FIELD_HOST{TS_MIME_FIELD_HOST, static_cast<size_t>(TS_
 const swoc::TextView HTTP_FIELD_LOCATION{TS_MIME_FIELD_LOCATION, static_cast<size_t>(TS_MIME_LEN_LOCATION)};
 const swoc::TextView HTTP_FIELD_CONTENT_LENGTH{TS_MIME_FIELD_CONTENT_LENGTH, static_cast<size_t>(TS_MIME_LEN_CONTENT_LENGTH)};
 const swoc::TextView HTTP_FIELD_CONTENT_TYPE{TS_MIME_FIELD_CONTENT_TYPE, static_cast<size_t>(TS_MIME_LEN_CONTENT_TYPE)};
+const swoc::TextView HTTP_FIELD_ETAG{TS_MIME_FIELD_ETAG, static_cast<size_t>(TS_MIME_LEN_ETAG)};
+const swoc::TextView HTTP_FIELD_LAST_MODIFIED{TS_MIME_FIELD_LAST_MODIFIED, static_cast<size_t>(TS_MIME_LEN_LAST_MODIFIED)};
+const swoc::TextView HTTP_FIELD_ACCEPT_RANGES{TS_MIME_FIELD_ACCEPT_RANGES, static_cast<size_t>(TS_MIME_LEN_ACCEPT_RANGES)};
+const swoc::TextView HTTP_FIELD_CONTENT_RANGE{TS_MIME_FIELD_CONTENT_RANGE, static_cast<size_t>(TS_MIME_LEN_CONTENT_RANGE)};
+const swoc::TextView HTTP_FIELD_RANGE{TS_MIME_FIELD_RANGE, static_cast<size_t>(TS_MIME_LEN_RANGE)};
+const swoc::TextView HTTP_FIELD_IF_RANGE{TS_MIME_FIELD_IF_RANGE, static_cast<size_t>(TS_MIME_LEN_IF_RANGE)};
+const swoc::TextView HTTP_FIELD_IF_NONE_MATCH{TS_MIME_FIELD_IF_NONE_MATCH, static_cast<size_t>(TS_MIME_LEN_IF_NONE_MATCH)};
+const swoc::TextView HTTP_FIELD_IF_MODIFIED_SINCE{TS_MIME_FIELD_IF_MODIFIED_SINCE, static_cast<size_t>(TS_MIME_LEN_IF_MODIFIED_SINCE)};
 
 const swoc::TextView URL_SCHEME_HTTP{TS_URL_SCHEME_HTTP, static_cast<size_t>(TS_URL_LEN_HTTP)};
 const swoc::TextView URL_SCHEME_HTTPS{TS_URL_SCHEME_HTTPS, static_cast<size_t>(TS_URL_LEN_HTTPS)};
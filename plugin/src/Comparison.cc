@@ -24,12 +24,49 @@ using swoc::Rv;
 
 Comparison::Factory Comparison::_factory;
 
+void *
+Comparison::operator new(size_t n, Config &cfg)
+{
+  return cfg.allocate_cfg_storage(n, alignof(std::max_align_t)).data();
+}
+
 unsigned
 Comparison::rxp_group_count() const
 {
   return 0;
 }
 
+bool
+Comparison::is_pure() const
+{
+  return false;
+}
+
+bool
+Comparison::accepts_sequence() const
+{
+  return false;
+}
+
+bool
+Comparison::string_filter(StringFilter &) const
+{
+  return false;
+}
+
+bool
+Comparison::StringFilter::operator()(TextView const &text) const
+{
+  if (text.size() < _min || text.size() > _max) {
+    return false;
+  }
+  // A required character means the minimum length is at least 1, so @a text is not empty.
+  auto same = [this](char c, int target) {
+    return (_nc ? tolower(static_cast<unsigned char>(c)) : static_cast<unsigned char>(c)) == target;
+  };
+  return (_first < 0 || same(text.front(), _first)) && (_last < 0 || same(text.back(), _last));
+}
+
 Errata
 Comparison::define(swoc::TextView name, ActiveType const &types, Comparison::Loader &&worker)
 {
@@ -72,6 +109,9 @@ Comparison::load(Config &cfg, YAML::Node node)
       if (!errata.is_ok()) {
         return std::move(errata);
       }
+      if (handle) {
+        cfg.count_comparison(*handle);
+      }
 
       return std::move(handle);
     }
@@ -99,6 +139,12 @@ public:
 
   bool operator()(Context &ctx, Feature const &feature) const override;
 
+  bool
+  is_pure() const override
+  {
+    return true;
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<Handle> load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node);
 
@@ -115,9 +161,9 @@ Cmp_otherwise::operator()(Context &, Feature const &) const
   return true;
 }
 Rv<Comparison::Handle>
-Cmp_otherwise::load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
+Cmp_otherwise::load(Config &cfg, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
 {
-  return {Handle{new self_type}, {}};
+  return {Handle{new (cfg) self_type}, {}};
 }
 /* ------------------------------------------------------------------------------------ */
 /** Utility base class for comparisons that are based on literal string matching.
@@ -184,6 +230,15 @@ public:
    */
   bool operator()(Context &ctx, feature_type_for<STRING> const &text) const override;
 
+  /// @return @c true if the comparison value is a literal.
+  bool
+  is_pure() const override
+  {
+    return _expr.is_literal();
+  }
+
+  bool string_filter(StringFilter &filter) const override;
+
   /** Instantiate an instance from YAML configuration.
    *
    * @param cfg Global configuration object.
@@ -196,10 +251,19 @@ public:
   static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
 
 protected:
-  Expr _expr; ///< To be compared to active feature.
+  Expr _expr;             ///< To be compared to active feature.
+  StringFilter _filter;   ///< Prefilter for a literal string value.
+  bool _filter_p = false; ///< @a _filter is valid.
 
   Cmp_LiteralString(Expr &&expr);
 
+  /** Set up the prefilter if the comparison value is a literal string.
+   *
+   * @param key Comparison key.
+   * @param options Comparison options.
+   */
+  void init_filter(TextView const &key, Options options);
+
   /** Specialized comparison.
    *
    * @param ctx Runtime context.
@@ -261,6 +325,49 @@ Cmp_LiteralString::operator()(Context &ctx, feature_type_for<STRING> const &feat
   return false;
 }
 
+bool
+Cmp_LiteralString::string_filter(StringFilter &filter) const
+{
+  if (_filter_p) {
+    filter = _filter;
+  }
+  return _filter_p;
+}
+
+void
+Cmp_LiteralString::init_filter(TextView const &key, Options options)
+{
+  if (!_expr.is_literal()) {
+    return;
+  }
+  auto view = std::get_if<IndexFor(STRING)>(&std::get<Expr::LITERAL>(_expr._raw));
+  if (nullptr == view) {
+    return;
+  }
+
+  TextView text{*view};
+  if (PATH_KEY == key && !options.f.nc) {
+    text.rtrim('/'); // same as the comparison.
+  }
+  auto mark = [&](char c) -> int {
+    return options.f.nc ? tolower(static_cast<unsigned char>(c)) : static_cast<unsigned char>(c);
+  };
+  _filter._nc  = options.f.nc;
+  _filter._min = text.size();
+  if (!text.empty()) {
+    if (MATCH_KEY == key) {
+      _filter._max   = text.size();
+      _filter._first = mark(text.front());
+      _filter._last  = mark(text.back());
+    } else if (PREFIX_KEY == key || PATH_KEY == key) {
+      _filter._first = mark(text.front());
+    } else if (SUFFIX_KEY == key || TLD_KEY == key) {
+      _filter._last = mark(text.back());
+    }
+  }
+  _filter_p = true;
+}
+
 /// Match entire string.
 class Cmp_MatchStd : public Cmp_LiteralString
 {
@@ -589,21 +696,24 @@ Cmp_LiteralString::load(Config &cfg, YAML::Node const &cmp_node, TextView const
     return Errata(S_ERROR,R"(Value type "{}" for comparison "{}" at {} is not supported.)", expr_type, key, cmp_node.Mark());
   }
 
+  Cmp_LiteralString *cmp = nullptr;
   if (MATCH_KEY == key) {
-    return options.f.nc ? Handle{new Cmp_MatchNC(std::move(expr))} : Handle{new Cmp_MatchStd(std::move(expr))};
+    cmp = options.f.nc ? static_cast<Cmp_LiteralString *>(new (cfg) Cmp_MatchNC(std::move(expr))) : new (cfg) Cmp_MatchStd(std::move(expr));
   } else if (PREFIX_KEY == key) {
-    return options.f.nc ? Handle{new Cmp_PrefixNC(std::move(expr))} : Handle{new Cmp_Prefix(std::move(expr))};
+    cmp = options.f.nc ? static_cast<Cmp_LiteralString *>(new (cfg) Cmp_PrefixNC(std::move(expr))) : new (cfg) Cmp_Prefix(std::move(expr));
   } else if (SUFFIX_KEY == key) {
-    return options.f.nc ? Handle{new Cmp_SuffixNC(std::move(expr))} : Handle{new Cmp_Suffix(std::move(expr))};
+    cmp = options.f.nc ? static_cast<Cmp_LiteralString *>(new (cfg) Cmp_SuffixNC(std::move(expr))) : new (cfg) Cmp_Suffix(std::move(expr));
   } else if (CONTAIN_KEY == key) {
-    return options.f.nc ? Handle(new Cmp_Contains(std::move(expr))) : Handle(new Cmp_ContainsNC(std::move(expr)));
+    cmp = options.f.nc ? static_cast<Cmp_LiteralString *>(new (cfg) Cmp_Contains(std::move(expr))) : new (cfg) Cmp_ContainsNC(std::move(expr));
   } else if (TLD_KEY == key) {
-    return options.f.nc ? Handle(new Cmp_TLDNC(std::move(expr))) : Handle(new Cmp_TLD(std::move(expr)));
+    cmp = options.f.nc ? static_cast<Cmp_LiteralString *>(new (cfg) Cmp_TLDNC(std::move(expr))) : new (cfg) Cmp_TLD(std::move(expr));
   } else if (PATH_KEY == key) {
-    return options.f.nc ? Handle(new Cmp_PathNC(std::move(expr))) : Handle(new Cmp_Path(std::move(expr)));
+    cmp = options.f.nc ? static_cast<Cmp_LiteralString *>(new (cfg) Cmp_PathNC(std::move(expr))) : new (cfg) Cmp_Path(std::move(expr));
+  } else {
+    return Errata(S_ERROR,R"(Internal error, unrecognized key "{}".)", key);
   }
-
-  return Errata(S_ERROR,R"(Internal error, unrecognized key "{}".)", key);
+  cmp->init_filter(key, options);
+  return Handle{cmp};
 }
 /* ------------------------------------------------------------------------------------ */
 class Cmp_Rxp : public Cmp_String
@@ -681,6 +791,8 @@ public:
   Cmp_RxpSingle(Expr &&expr, Rxp::Options);
   Cmp_RxpSingle(Rxp &&rxp);
 
+  bool is_pure() const override;
+
 protected:
   bool operator()(Context &ctx, feature_type_for<STRING> const &active) const override;
 
@@ -697,6 +809,8 @@ class Cmp_RxpList : public Cmp_Rxp
 public:
   Cmp_RxpList(Rxp::Options opt) : _opt(opt) {}
 
+  bool is_pure() const override;
+
 protected:
   struct expr_visitor {
     Errata operator()(Feature &f);
@@ -785,8 +899,8 @@ Cmp_Rxp::expr_visitor::operator()(Feature &f)
     rxp_errata.note(R"(While parsing feature expression for "{}" comparison.)", KEY);
     return std::move(rxp_errata);
   }
-  _cfg.require_rxp_group_count(rxp.capture_count());
-  return Handle(new Cmp_RxpSingle(std::move(rxp)));
+  _cfg.require_rxp(rxp);
+  return Handle(new (_cfg) Cmp_RxpSingle(std::move(rxp)));
 }
 
 Rv<Comparison::Handle> Cmp_Rxp::expr_visitor::operator()(std::monostate)
@@ -797,19 +911,19 @@ Rv<Comparison::Handle> Cmp_Rxp::expr_visitor::operator()(std::monostate)
 Rv<Comparison::Handle>
 Cmp_Rxp::expr_visitor::operator()(Expr::Direct &d)
 {
-  return Handle(new Cmp_RxpSingle(Expr{std::move(d)}, _rxp_opt));
+  return Handle(new (_cfg) Cmp_RxpSingle(Expr{std::move(d)}, _rxp_opt));
 }
 
 Rv<Comparison::Handle>
 Cmp_Rxp::expr_visitor::operator()(Expr::Composite &comp)
 {
-  return Handle(new Cmp_RxpSingle(Expr{std::move(comp)}, _rxp_opt));
+  return Handle(new (_cfg) Cmp_RxpSingle(Expr{std::move(comp)}, _rxp_opt));
 }
 
 Rv<Comparison::Handle>
 Cmp_Rxp::expr_visitor::operator()(Expr::List &l)
 {
-  auto rxm = new Cmp_RxpList{_rxp_opt};
+  auto rxm = new (_cfg) Cmp_RxpList{_rxp_opt};
   Cmp_RxpList::expr_visitor ev{_rxp_opt, rxm->_rxp};
   for (Expr &elt : l._exprs) {
     if (!elt.result_type().can_satisfy(STRING)) {
@@ -817,6 +931,11 @@ Cmp_Rxp::expr_visitor::operator()(Expr::List &l)
     }
     std::visit(ev, elt._raw);
   }
+  for (auto const &item : rxm->_rxp) {
+    if (auto rxp = std::get_if<Rxp>(&item); rxp != nullptr) {
+      _cfg.require_rxp(*rxp);
+    }
+  }
   return Handle{rxm};
 }
 
@@ -851,12 +970,24 @@ Cmp_RxpSingle::operator()(Context &ctx, feature_type_for<STRING> const &active)
   return std::visit(rxp_visitor{ctx, _opt, active}, _rxp);
 }
 
+bool
+Cmp_RxpSingle::is_pure() const
+{
+  return std::holds_alternative<Rxp>(_rxp);
+}
+
 bool
 Cmp_RxpList::operator()(Context &ctx, feature_type_for<STRING> const &) const
 {
   return std::any_of(_rxp.begin(), _rxp.end(), [&](Item const &item) { return std::visit(rxp_visitor{ctx, _opt, {}}, item); });
 }
 
+bool
+Cmp_RxpList::is_pure() const
+{
+  return std::all_of(_rxp.begin(), _rxp.end(), [](Item const &item) { return std::holds_alternative<Rxp>(item); });
+}
+
 /* ------------------------------------------------------------------------------------ */
 /** Compare a boolean value.
  * Check if a value is true.
@@ -871,6 +1002,12 @@ public:
 
   bool operator()(Context &ctx, Feature const &feature) const;
 
+  bool
+  is_pure() const override
+  {
+    return true;
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<Handle> load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node);
 
@@ -885,9 +1022,9 @@ Cmp_is_true::operator()(Context &, Feature const &feature) const
 }
 
 Rv<Comparison::Handle>
-Cmp_is_true::load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
+Cmp_is_true::load(Config &cfg, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
 {
-  return {Handle{new self_type}, {}};
+  return {Handle{new (cfg) self_type}, {}};
 }
 
 /** Compare a boolean value.
@@ -903,6 +1040,12 @@ public:
 
   bool operator()(Context &ctx, Feature const &feature) const;
 
+  bool
+  is_pure() const override
+  {
+    return true;
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<Handle> load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node);
 
@@ -920,9 +1063,9 @@ Cmp_is_false::operator()(Context &, Feature const &feature) const
 }
 
 Rv<Comparison::Handle>
-Cmp_is_false::load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
+Cmp_is_false::load(Config &cfg, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
 {
-  return {Handle{new self_type}, {}};
+  return {Handle{new (cfg) self_type}, {}};
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -938,6 +1081,12 @@ public:
 
   bool operator()(Context &ctx, feature_type_for<NIL>) const override;
 
+  bool
+  is_pure() const override
+  {
+    return true;
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<Handle> load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node);
 
@@ -955,9 +1104,9 @@ Cmp_is_null::operator()(Context &, feature_type_for<NIL>) const
 }
 
 Rv<Comparison::Handle>
-Cmp_is_null::load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
+Cmp_is_null::load(Config &cfg, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
 {
-  return {Handle{new self_type}, {}};
+  return {Handle{new (cfg) self_type}, {}};
 }
 /* ------------------------------------------------------------------------------------ */
 /** Check for empty (NULL or empty string)
@@ -974,6 +1123,12 @@ public:
   bool operator()(Context &ctx, feature_type_for<STRING> const &s) const override;
   bool operator()(Context &ctx, feature_type_for<TUPLE> const &s) const override;
 
+  bool
+  is_pure() const override
+  {
+    return true;
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<Handle> load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node);
 
@@ -1003,9 +1158,9 @@ Cmp_is_empty::operator()(Context &, feature_type_for<TUPLE> const &t) const
 }
 
 Rv<Comparison::Handle>
-Cmp_is_empty::load(Config &, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
+Cmp_is_empty::load(Config &cfg, YAML::Node const &, TextView const &, TextView const &, YAML::Node)
 {
-  return {Handle{new self_type}, {}};
+  return {Handle{new (cfg) self_type}, {}};
 }
 /* ------------------------------------------------------------------------------------ */
 /// Common elements for all binary integer comparisons.
@@ -1033,6 +1188,13 @@ public:
   template <typename T>
   static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
 
+  /// @return @c true if the comparison value is a literal.
+  bool
+  is_pure() const override
+  {
+    return _expr.is_literal();
+  }
+
 protected:
   Expr _expr;
 
@@ -1052,7 +1214,7 @@ Base_Binary_Cmp::load(Config &cfg, YAML::Node const &, TextView const &key, Text
     return Errata(S_ERROR, R"(The value is of type "{}" for "{}" at {} which is not "{}" as required.)", expr_type, key, value_node.Mark(),
                  TYPES);
   }
-  return Handle(new T(std::move(expr)));
+  return Handle(new (cfg) T(std::move(expr)));
 }
 
 // --- The concrete comparisons.
@@ -1178,6 +1340,13 @@ public:
   bool operator()(Context &ctx, feature_type_for<INTEGER> n) const override;
   bool operator()(Context &ctx, feature_type_for<IP_ADDR> const &addr) const override;
 
+  /// @return @c true if both range boundaries are literals.
+  bool
+  is_pure() const override
+  {
+    return _min.is_literal() && _max.is_literal();
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
 
@@ -1210,7 +1379,7 @@ Cmp_in::operator()(Context &ctx, feature_type_for<INTEGER> n) const
 auto
 Cmp_in::load(Config &cfg, YAML::Node const &cmp_node, TextView const &, TextView const &, YAML::Node value_node) -> Rv<Handle>
 {
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle{self};
 
   if (value_node.IsScalar()) {
@@ -1307,6 +1476,13 @@ public:
 
   virtual TextView const &key() const = 0;
 
+  /// @return @c true if all nested comparisons are pure.
+  bool
+  is_pure() const override
+  {
+    return std::all_of(_cmps.begin(), _cmps.end(), [](Handle const &cmp) { return cmp->is_pure(); });
+  }
+
   /// Construct an instance from YAML configuration.
   static Rv<std::vector<Handle>> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg,
                                       YAML::Node value_node);
@@ -1393,7 +1569,7 @@ Cmp_any_of::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, T
   if (!errata.is_ok()) {
     return std::move(errata);
   }
-  return Handle{new self_type{std::move(cmps)}};
+  return Handle{new (cfg) self_type{std::move(cmps)}};
 }
 
 // ---
@@ -1433,7 +1609,7 @@ Cmp_all_of::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, T
   if (!errata.is_ok()) {
     return std::move(errata);
   }
-  return Handle{new self_type{std::move(cmps)}};
+  return Handle{new (cfg) self_type{std::move(cmps)}};
 }
 
 // ---
@@ -1473,15 +1649,57 @@ Cmp_none_of::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key,
   if (!errata.is_ok()) {
     return std::move(errata);
   }
-  return Handle{new self_type{std::move(cmps)}};
+  return Handle{new (cfg) self_type{std::move(cmps)}};
 }
 
 // ---
 
-class Cmp_for_all : public Comparison
+/** Utility base class for comparisons that apply a nested comparison to each element of a list.
+ * This is @b not intended to be used as a comparison itself.
+ */
+class ElementComparison : public Comparison
 {
-  using self_type  = Cmp_for_all; ///< Self reference type.
-  using super_type = Comparison;  ///< Parent type.
+  using self_type  = ElementComparison; ///< Self reference type.
+  using super_type = Comparison;        ///< Parent type.
+public:
+  bool
+  is_pure() const override
+  {
+    return _cmp->is_pure();
+  }
+
+  bool
+  accepts_sequence() const override
+  {
+    return true;
+  }
+
+protected:
+  Comparison::Handle _cmp; ///< Comparison for each element.
+  StringFilter _filter;    ///< Prefilter for string elements.
+  bool _filter_p = false;  ///< Use @a _filter.
+
+  explicit ElementComparison(Handle &&cmp) : _cmp(std::move(cmp)) { _filter_p = _cmp->string_filter(_filter); }
+
+  /// @return The nested comparison result for @a f.
+  bool
+  element_match(Context &ctx, Feature const &f) const
+  {
+    if (_filter_p) {
+      if (auto view = std::get_if<IndexFor(STRING)>(&f); view && !_filter(*view)) {
+        return false;
+      }
+    }
+    return (*_cmp)(ctx, f);
+  }
+};
+
+// ---
+
+class Cmp_for_all : public ElementComparison
+{
+  using self_type  = Cmp_for_all;       ///< Self reference type.
+  using super_type = ElementComparison; ///< Parent type.
 public:
   static constexpr TextView KEY = "for-all"; ///< Comparison name.
   static const ActiveType TYPES;             ///< Supported types.
@@ -1497,8 +1715,7 @@ public:
   static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
 
 protected:
-  Comparison::Handle _cmp;
-  explicit Cmp_for_all(Handle &&cmp) : _cmp(std::move(cmp)) {}
+  explicit Cmp_for_all(Handle &&cmp) : super_type(std::move(cmp)) {}
 };
 
 const ActiveType Cmp_for_all::TYPES{ActiveType::any_type()};
@@ -1506,12 +1723,7 @@ const ActiveType Cmp_for_all::TYPES{ActiveType::any_type()};
 bool
 Cmp_for_all::operator()(Context &ctx, Feature const &feature) const
 {
-  if (TUPLE != ValueTypeOf(feature)) {
-    return (*_cmp)(ctx, feature);
-  }
-
-  auto &t{std::get<TUPLE>(feature)};
-  return std::all_of(t.begin(), t.end(), [&](Feature const &f) { return (*_cmp)(ctx, f); });
+  return for_each_element(feature, [&](Feature const &f) { return this->element_match(ctx, f); });
 }
 
 auto
@@ -1527,15 +1739,15 @@ Cmp_for_all::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key,
     errata.note("While parsing nested comparison of {} at {}.", key, cmp_node.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(cmp)});
+  return Handle(new (cfg) self_type{std::move(cmp)});
 }
 
 // ---
 
-class Cmp_for_any : public Comparison
+class Cmp_for_any : public ElementComparison
 {
-  using self_type  = Cmp_for_any; ///< Self reference type.
-  using super_type = Comparison;  ///< Parent type.
+  using self_type  = Cmp_for_any;       ///< Self reference type.
+  using super_type = ElementComparison; ///< Parent type.
 public:
   static constexpr TextView KEY = "for-any"; ///< Comparison name.
   static const ActiveType TYPES;             ///< Supported types.
@@ -1551,8 +1763,7 @@ public:
   static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
 
 protected:
-  Comparison::Handle _cmp;
-  explicit Cmp_for_any(Handle &&cmp) : _cmp(std::move(cmp)) {}
+  explicit Cmp_for_any(Handle &&cmp) : super_type(std::move(cmp)) {}
 };
 
 const ActiveType Cmp_for_any::TYPES{ActiveType::any_type()};
@@ -1560,12 +1771,8 @@ const ActiveType Cmp_for_any::TYPES{ActiveType::any_type()};
 bool
 Cmp_for_any::operator()(Context &ctx, Feature const &feature) const
 {
-  if (TUPLE != ValueTypeOf(feature)) {
-    return (*_cmp)(ctx, feature);
-  }
-
-  auto &t{std::get<TUPLE>(feature)};
-  return std::any_of(t.begin(), t.end(), [&](Feature const &f) { return (*_cmp)(ctx, f); });
+  // Iteration stops at the first match.
+  return !for_each_element(feature, [&](Feature const &f) { return !this->element_match(ctx, f); });
 }
 
 auto
@@ -1581,15 +1788,15 @@ Cmp_for_any::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key,
     errata.note("While parsing nested comparison of {} at {}.", key, cmp_node.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(cmp)});
+  return Handle(new (cfg) self_type{std::move(cmp)});
 }
 
 // ---
 
-class Cmp_for_none : public Comparison
+class Cmp_for_none : public ElementComparison
 {
-  using self_type  = Cmp_for_none; ///< Self reference type.
-  using super_type = Comparison;   ///< Parent type.
+  using self_type  = Cmp_for_none;      ///< Self reference type.
+  using super_type = ElementComparison; ///< Parent type.
 public:
   static constexpr TextView KEY = "for-none"; ///< Comparison name.
   static const ActiveType TYPES;              ///< Supported types.
@@ -1605,8 +1812,7 @@ public:
   static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
 
 protected:
-  Comparison::Handle _cmp;
-  explicit Cmp_for_none(Handle &&cmp) : _cmp(std::move(cmp)) {}
+  explicit Cmp_for_none(Handle &&cmp) : super_type(std::move(cmp)) {}
 };
 
 const ActiveType Cmp_for_none::TYPES{ActiveType::any_type()};
@@ -1614,12 +1820,7 @@ const ActiveType Cmp_for_none::TYPES{ActiveType::any_type()};
 bool
 Cmp_for_none::operator()(Context &ctx, Feature const &feature) const
 {
-  if (TUPLE != ValueTypeOf(feature)) {
-    return (*_cmp)(ctx, feature);
-  }
-
-  auto &t{std::get<TUPLE>(feature)};
-  return std::all_of(t.begin(), t.end(), [&](Feature const &f) { return (*_cmp)(ctx, f); });
+  return for_each_element(feature, [&](Feature const &f) { return !this->element_match(ctx, f); });
 }
 
 auto
@@ -1635,7 +1836,7 @@ Cmp_for_none::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key,
     errata.note("While parsing nested comparison of {} at {}.", key, cmp_node.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(cmp)});
+  return Handle(new (cfg) self_type{std::move(cmp)});
 }
 
 // ---
@@ -1699,7 +1900,7 @@ Cmp_as_tuple::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key,
   if (!errata.is_ok()) {
     return std::move(errata);
   }
-  return Handle{new self_type{std::move(cmps)}};
+  return Handle{new (cfg) self_type{std::move(cmps)}};
 }
 
 // --- ComparisonGroup --- //
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <map>
+#include <chrono>
 #include <numeric>
 #include <glob.h>
 
@@ -18,6 +19,7 @@
 #include <yaml-cpp/yaml.h>
 
 #include "txn_box/Directive.h"
+#include "txn_box/Comparison.h"
 #include "txn_box/Extractor.h"
 #include "txn_box/Modifier.h"
 #include "txn_box/Expr.h"
@@ -99,6 +101,10 @@ Config::~Config()
     f._f(f._ptr);
     std::destroy_at(&f._f); // clean up the cleaner too, just in case.
   }
+  // The directives are in the arena, which is destroyed before the directive roots.
+  for (auto &list : _roots) {
+    list.clear();
+  }
 }
 
 template <typename F> struct on_scope_exit {
@@ -161,6 +167,23 @@ Config::allocate_cfg_storage(size_t n, size_t align)
   }
 }
 
+Config &
+Config::on_warm_up(std::function<void()> &&task)
+{
+  _warm_up_tasks.emplace_back(std::move(task));
+  return *this;
+}
+
+void
+Config::warm_up()
+{
+  for (auto const &task : _warm_up_tasks) {
+    task();
+  }
+  _warm_up_tasks.clear();
+  _warm_up_tasks.shrink_to_fit();
+}
+
 ReservedSpan
 Config::reserve_ctx_storage(size_t n)
 {
@@ -181,18 +204,24 @@ Config::localize(Feature &feature)
 }
 
 std::string_view &
-Config::localize(std::string_view &text, LocalOpt opt)
+Config::localize(std::string_view &text, LocalOpt)
 {
   if (text.size()) {
-    if (LOCAL_CSTR == opt) {
-      auto span{_arena.alloc(text.size() + 1).rebind<char>()};
-      memcpy(span, text);
-      span[text.size()] = 0;
-      text              = span.subspan(0, text.size()).view();
-    } else {
-      auto span{_arena.alloc(text.size()).rebind<char>()};
-      memcpy(span, text);
-      text = span.view();
+    ++_text_count;
+    _text_bytes += text.size();
+    if (_intern_p) {
+      if (auto spot = _interned.find(text); spot != _interned.end()) {
+        return text = *spot;
+      }
+    }
+    // Always terminate so an interned copy works for either @a opt.
+    auto span{_arena.alloc(text.size() + 1).rebind<char>()};
+    memcpy(span, text);
+    span[text.size()] = 0;
+    text              = span.subspan(0, text.size()).view();
+    _text_stored += span.size();
+    if (_intern_p) {
+      _interned.insert(text);
     }
   }
   return text;
@@ -486,6 +515,44 @@ Config::parse_expr(YAML::Node expr_node)
   return expr;
 }
 
+Config::self_type &
+Config::require_rxp(Rxp const &rxp)
+{
+  this->require_rxp_group_count(rxp.capture_count());
+  ++_element_counts._rxps[IndexFor(this->current_hook())];
+  ++_rxp_count;
+  _rxp_bytes += rxp.size();
+  return *this;
+}
+
+Config::self_type &
+Config::count_comparison(Comparison const &cmp)
+{
+  ++_element_counts._comparisons[IndexFor(this->current_hook())];
+  if (cmp.is_pure()) {
+    ++_element_counts._pure_comparisons;
+  }
+  cmp.can_accelerate(_element_counts._accelerators);
+  return *this;
+}
+
+Config::MemoryInfo
+Config::memory_info() const
+{
+  MemoryInfo zret;
+  zret._arena_allocated = _arena.size();
+  zret._arena_reserved  = _arena.reserved_size();
+  for (auto const &info : _drtv_info) {
+    zret._directive_count += info._count;
+  }
+  zret._rxp_count   = _rxp_count;
+  zret._rxp_bytes   = _rxp_bytes;
+  zret._text_count  = _text_count;
+  zret._text_bytes  = _text_bytes;
+  zret._text_stored = _text_stored;
+  return zret;
+}
+
 Rv<Directive::Handle>
 Config::load_directive(YAML::Node const &drtv_node)
 {
@@ -528,6 +595,7 @@ Config::load_directive(YAML::Node const &drtv_node)
         return std::move(drtv_errata);
       }
       drtv->_rtti = rtti;
+      ++_element_counts._directives[IndexFor(this->current_hook())];
 
       return std::move(drtv);
     }
@@ -542,7 +610,7 @@ Config::parse_directive(YAML::Node const &drtv_node)
     return this->load_directive(drtv_node);
   } else if (drtv_node.IsSequence()) {
     Errata zret;
-    auto list{new DirectiveList};
+    auto list{new (*this) DirectiveList};
     Directive::Handle drtv_list{list};
     for (auto child : drtv_node) {
       auto &&[handle, errata]{this->load_directive(child)};
@@ -555,7 +623,7 @@ Config::parse_directive(YAML::Node const &drtv_node)
     }
     return drtv_list;
   } else if (drtv_node.IsNull()) {
-    return Directive::Handle(new NilDirective);
+    return Directive::Handle(new (*this) NilDirective);
   }
   return Errata(S_ERROR, R"(Directive at {} is not an object or a sequence as required.)", drtv_node.Mark());
 }
@@ -669,6 +737,7 @@ Config::drtv_info(swoc::TextView const &name) const
 Errata
 Config::load_file(swoc::file::path const &cfg_path, TextView cfg_key, YamlCache *cache)
 {
+  FileInfo *info = nullptr;
   if (auto spot = _cfg_files.find(cfg_path); spot != _cfg_files.end()) {
     if (spot->second.has_cfg_key(cfg_key)) {
       ts::DebugMsg(R"(Skipping "{}":{} - already loaded)", cfg_path, cfg_key);
@@ -676,10 +745,18 @@ Config::load_file(swoc::file::path const &cfg_path, TextView cfg_key, YamlCache
     } else {
       spot->second.add_cfg_key(cfg_key);
     }
+    info = &spot->second;
   } else { // not found - put it in the table.
     auto [iter, flag] = _cfg_files.emplace(FileInfoMap::value_type{cfg_path, {}});
     iter->second.add_cfg_key(cfg_key);
+    info = &iter->second;
   }
+  // Record the load time however the load finishes.
+  struct LoadTimer {
+    FileInfo *_info;
+    std::chrono::steady_clock::time_point _t0;
+    ~LoadTimer() { _info->_load_time += std::chrono::steady_clock::now() - _t0; }
+  } timer{info, std::chrono::steady_clock::now()};
 
   YAML::Node root;
   // Try loading and parsing the file.
@@ -807,7 +884,14 @@ Config::load_cli_args(Handle handle, swoc::MemSpan<char const *> argv, int arg_i
   }
   // Done with the files - clear them out.
   _cfg_file_count = _cfg_files.size();
+  _file_load_times.clear();
+  for (auto const &[path, info] : _cfg_files) {
+    _file_load_times.emplace_back(path, info._load_time);
+  }
   _cfg_files.clear();
+  // Done loading, interning is no longer useful.
+  _intern_p = false;
+  decltype(_interned)().swap(_interned);
   return {};
 }
 
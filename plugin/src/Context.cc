@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: Apache-2.0
 */
 
+#include <array>
+
 #include <swoc/MemSpan.h>
 #include <swoc/ArenaWriter.h>
 
@@ -21,6 +23,37 @@ using swoc::FixedBufferWriter;
 using swoc::ArenaWriter;
 using namespace swoc::literals;
 
+namespace
+{
+/// Context memory statistics, aggregated over all transactions.
+enum MemoryStat {
+  MEM_CTX_COUNT,
+  MEM_ARENA_ALLOCATED,
+  MEM_ARENA_RESERVED,
+  MEM_ARENA_EXTRA,
+  MEM_TRANSIENT_GROW_COUNT,
+  MEM_TRANSIENT_GROW_BYTES,
+  MEM_FINALIZER_COUNT,
+  MEM_OVERFLOW_COUNT,
+  MEM_OVERFLOW_BYTES,
+  MEM_RXP_BYTES,
+  N_MEMORY_STATS
+};
+
+/// Memory statistic name prefix.
+constexpr TextView MEMORY_STAT_PREFIX = "plugin.txn_box.memory.ctx.";
+/// Memory statistic names, in @c MemoryStat order.
+const std::array<TextView, N_MEMORY_STATS> Memory_Stat_Name{"count",          "arena.allocated",     "arena.reserved",
+                                                            "arena.extra",    "transient.grow.count", "transient.grow.bytes",
+                                                            "finalizer.count", "overflow.count",     "overflow.bytes",
+                                                            "rxp.bytes"};
+/// Memory statistic indices, valid only if @c Memory_Stats_p is @c true.
+std::array<int, N_MEMORY_STATS> Memory_Stat_Idx;
+/// Set if the memory statistics have been defined.
+bool Memory_Stats_p = false;
+
+} // namespace
+
 /* ------------------------------------------------------------------------------------ */
 bool
 Expr::bwf_ex::operator()(std::string_view &literal, Extractor::Spec &spec)
@@ -46,9 +79,14 @@ Context::Context(std::shared_ptr<Config> const &cfg) : _cfg(cfg)
   size_t reserved_size = G._remap_ctx_storage_required + (cfg ? cfg->reserved_ctx_storage_size() : 0);
   // This is arranged so @a _arena destructor will clean up properly, nothing more need be done.
   _arena.reset(swoc::MemArena::construct_self_contained(4000 + reserved_size));
+  _mem._arena_initial = _arena->reserved_size();
 
   _rxp_ctx = pcre2_general_context_create(
-    [](PCRE2_SIZE size, void *ctx) -> void * { return static_cast<self_type *>(ctx)->_arena->alloc(size).data(); },
+    [](PCRE2_SIZE size, void *ctx) -> void * {
+      auto self = static_cast<self_type *>(ctx);
+      self->_mem._rxp_bytes += size;
+      return self->_arena->alloc(size).data();
+    },
     [](void *, void *) -> void {}, this);
   if (cfg) {
     /// Make sure there are sufficient capture groups.
@@ -64,6 +102,25 @@ Context::Context(std::shared_ptr<Config> const &cfg) : _cfg(cfg)
 
 Context::~Context()
 {
+  if (Memory_Stats_p) {
+    auto info = this->memory_info();
+    std::array<size_t, N_MEMORY_STATS> values{1,
+                                              info._arena_allocated,
+                                              info._arena_reserved,
+                                              info._arena_reserved - info._arena_initial,
+                                              info._transient_grow_count,
+                                              info._transient_grow_bytes,
+                                              info._finalizer_count,
+                                              info._overflow_count,
+                                              info._overflow_bytes,
+                                              info._rxp_bytes};
+    for (unsigned idx = 0; idx < N_MEMORY_STATS; ++idx) {
+      if (values[idx] > 0) {
+        ts::plugin_stat_update(Memory_Stat_Idx[idx], values[idx]);
+      }
+    }
+  }
+
   // Invoke all the finalizers to do additional cleanup.
   for (auto &&f : _finalizers) {
     f._f(f._ptr);
@@ -83,7 +140,7 @@ Context::on_hook_do(Hook hook_idx, Directive *drtv)
   auto &info{_hooks[IndexFor(hook_idx)]};
   if (!info.hook_set_p) { // no hook to invoke this directive, set one up.
     if (hook_idx >= _cur_hook) {
-      TSHttpTxnHookAdd(_txn, TS_Hook[IndexFor(hook_idx)], _cont);
+      TSHttpTxnHookAdd(_txn, TS_Hook[IndexFor(hook_idx)], txn_cont());
       info.hook_set_p = true;
     } else if (hook_idx < _cur_hook) {
       // error condition - should report. Also, should detect this on config load.
@@ -197,6 +254,15 @@ Context::extract(Expr const &expr)
   return value;
 }
 
+Feature
+Context::extract_sequence(Expr const &expr)
+{
+  if (auto d = std::get_if<Expr::DIRECT>(&expr._raw); d && expr._mods.empty()) {
+    return d->_spec._exf->extract_sequence(*this, d->_spec);
+  }
+  return this->extract(expr);
+}
+
 FeatureView
 Context::extract_view(const Expr &expr, std::initializer_list<ViewOption> opts)
 {
@@ -332,33 +398,46 @@ Context::proxy_rsp_hdr()
 Context::self_type &
 Context::enable_hooks(TSHttpTxn txn)
 {
-  // Create a continuation to hold the data.
-  _cont = TSContCreate(ts_callback, TSContMutexGet(reinterpret_cast<TSCont>(txn)));
-  TSContDataSet(_cont, this);
-  _txn = txn;
+  auto cont = txn_cont();
+  _txn      = txn;
+  // The callback finds this context through the transaction argument.
+  _txn.arg_assign(G.TxnArgIdx, this);
 
   // set hooks for top level directives.
   if (_cfg) {
     for (unsigned idx = 0; idx < std::tuple_size<Hook>::value; ++idx) {
       auto const &drtv_list{_cfg->hook_directives(static_cast<Hook>(idx))};
       if (!drtv_list.empty()) {
-        TSHttpTxnHookAdd(txn, TS_Hook[idx], _cont);
+        TSHttpTxnHookAdd(txn, TS_Hook[idx], cont);
         _hooks[idx].hook_set_p = true;
       }
     }
   }
 
-  // Always set a cleanup hook.
-  TSHttpTxnHookAdd(txn, TS_HTTP_TXN_CLOSE_HOOK, _cont);
-  _txn.arg_assign(G.TxnArgIdx, this);
+  // Always set a cleanup hook, but only once - a second callback would be after the cleanup.
+  if (auto &info{_hooks[IndexFor(Hook::TXN_CLOSE)]}; !info.hook_set_p) {
+    TSHttpTxnHookAdd(txn, TS_HTTP_TXN_CLOSE_HOOK, cont);
+    info.hook_set_p = true;
+  }
   return *this;
 }
 
+TSCont
+Context::txn_cont()
+{
+  static TSCont cont = TSContCreate(ts_callback, nullptr);
+  return cont;
+}
+
 int
-Context::ts_callback(TSCont cont, TSEvent evt, void *)
+Context::ts_callback(TSCont, TSEvent evt, void *payload)
 {
-  self_type *self      = static_cast<self_type *>(TSContDataGet(cont));
-  auto txn             = self->_txn; // cache for TXN_CLOSE.
+  ts::HttpTxn txn{static_cast<TSHttpTxn>(payload)};
+  self_type *self = static_cast<self_type *>(txn.arg(G.TxnArgIdx));
+  if (nullptr == self) { // shouldn't happen, but don't stall the transaction.
+    TSHttpTxnReenable(txn, TS_EVENT_HTTP_CONTINUE);
+    return TS_SUCCESS;
+  }
   self->_global_status = TS_EVENT_HTTP_CONTINUE;
 
   // Run the directives.
@@ -367,14 +446,15 @@ Context::ts_callback(TSCont cont, TSEvent evt, void *)
     self->invoke_for_hook(hook);
   }
 
+  auto status = self->_global_status; // cache for TXN_CLOSE.
+
   /// TXN Close is special - do internal cleanup after explicit directives are done.
   if (TS_EVENT_HTTP_TXN_CLOSE == evt) {
-    TSContDataSet(cont, nullptr);
-    TSContDestroy(cont);
+    txn.arg_assign(G.TxnArgIdx, nullptr);
     delete self;
   }
 
-  TSHttpTxnReenable(txn, self->_global_status);
+  TSHttpTxnReenable(txn, status);
   return TS_SUCCESS;
 }
 
@@ -465,6 +545,8 @@ Context::overflow_storage_for(const ReservedSpan &span)
   item->_storage = _arena->alloc(span.n + sizeof(ReservedStatus), alignof(ReservedStatus));
   memset(item->_storage, 0);
   item->_storage.remove_prefix(sizeof(ReservedStatus));
+  ++_mem._overflow_count;
+  _mem._overflow_bytes += span.n;
 
   return item->_storage;
 }
@@ -473,6 +555,7 @@ swoc::MemSpan<char>
 Context::transient_buffer(size_t required)
 {
   this->commit_transient();
+  this->transient_grow_check(required);
   auto span{_arena->require(required).remnant().rebind<char>()};
   _transient = TRANSIENT_ACTIVE;
   return span;
@@ -482,10 +565,60 @@ Context::self_type &
 Context::transient_require(size_t n)
 {
   this->commit_transient();
+  this->transient_grow_check(n);
   _arena->require(n);
   return *this;
 }
 
+void
+Context::transient_grow_check(size_t n)
+{
+  if (_arena->remnant().size() < n) {
+    ++_mem._transient_grow_count;
+    _mem._transient_grow_bytes += n;
+  }
+}
+
+Context::MemoryInfo
+Context::memory_info() const
+{
+  MemoryInfo zret{_mem};
+  zret._arena_allocated = _arena->size();
+  zret._arena_reserved  = _arena->reserved_size();
+  return zret;
+}
+
+Errata
+Context::memory_stats_define()
+{
+  std::string name;
+  for (unsigned idx = 0; idx < N_MEMORY_STATS; ++idx) {
+    swoc::bwprint(name, "{}{}", MEMORY_STAT_PREFIX, Memory_Stat_Name[idx]);
+    auto &&[stat_idx, errata]{ts::plugin_stat_define(name, 0, false)};
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+    Memory_Stat_Idx[idx] = stat_idx;
+  }
+  Memory_Stats_p = true;
+  return {};
+}
+
+BufferWriter &
+Context::memory_stats_print(BufferWriter &w)
+{
+  if (!Memory_Stats_p) {
+    return w.write("Context memory statistics are not enabled.\n");
+  }
+  auto n = ts::plugin_stat_value(Memory_Stat_Idx[MEM_CTX_COUNT]);
+  w.print("{}{} {}\n", MEMORY_STAT_PREFIX, Memory_Stat_Name[MEM_CTX_COUNT], n);
+  for (unsigned idx = MEM_CTX_COUNT + 1; idx < N_MEMORY_STATS; ++idx) {
+    auto value = ts::plugin_stat_value(Memory_Stat_Idx[idx]);
+    w.print("{}{} {} - {} per transaction\n", MEMORY_STAT_PREFIX, Memory_Stat_Name[idx], value, n > 0 ? value / n : 0);
+  }
+  return w;
+}
+
 Context::self_type &
 Context::commit_transient()
 {
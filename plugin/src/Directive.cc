@@ -16,6 +16,12 @@ using swoc::Rv;
 using swoc::TextView;
 
 /* ------------------------------------------------------------------------------------ */
+void *
+Directive::operator new(size_t n, Config &cfg)
+{
+  return cfg.allocate_cfg_storage(n, alignof(std::max_align_t)).data();
+}
+
 DirectiveList &
 DirectiveList::push_back(Directive::Handle &&d)
 {
@@ -1062,7 +1062,49 @@ public:
 
   Feature extract(Context &ctx, Spec const &spec) override;
 
+  Feature extract_sequence(Context &ctx, Spec const &spec) override;
+
 protected:
+  /// Duplicate field values, generated from the header as iterated.
+  class FieldSequence : public FeatureSequence
+  {
+  public:
+    FieldSequence(ts::HttpHeader const &hdr, TextView name) : _hdr(hdr), _name(name) { this->rewind(); }
+
+    Feature
+    extract() const override
+    {
+      if (_field.is_valid()) {
+        return _field.value();
+      }
+      return NIL_FEATURE;
+    }
+
+    bool
+    is_nil() const override
+    {
+      return !_field.is_valid();
+    }
+
+    bool
+    next() override
+    {
+      _field = _field.next_dup();
+      return _field.is_valid();
+    }
+
+    void
+    rewind() override
+    {
+      _field = _hdr.field(_name);
+    }
+
+  protected:
+    ts::HttpHeader _hdr;  ///< Header containing the fields.
+    TextView _name;       ///< Field name.
+    ts::HttpField _field; ///< Current field.
+  };
+
   struct Data {
     TextView _arg;
     union {
@@ -1131,6 +1173,27 @@ ExHttpField::extract(Context &ctx, const Spec &spec)
   return NIL_FEATURE;
 };
 
+Feature
+ExHttpField::extract_sequence(Context &ctx, const Spec &spec)
+{
+  Data &data = spec._data.span.rebind<Data>()[0];
+  if (data.opt.all) { // by-field and by-value are not sequences.
+    return this->extract(ctx, spec);
+  }
+
+  if (ts::HttpHeader hdr{this->hdr(ctx)}; hdr.is_valid()) {
+    if (auto field{hdr.field(data._arg)}; field.is_valid()) {
+      if (field.next_dup().is_valid()) {
+        auto seq = ctx.make<FieldSequence>(hdr, data._arg);
+        ctx.mark_for_cleanup(seq); // release the field handle.
+        return static_cast<Generic *>(seq);
+      }
+      return field.value();
+    }
+  }
+  return NIL_FEATURE;
+}
+
 // -----
 class Ex_ua_req_field : public ExHttpField
 {
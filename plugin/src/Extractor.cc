@@ -55,6 +55,12 @@ Extractor::extract(Config &, Extractor::Spec const &)
   return NIL_FEATURE;
 }
 
+Feature
+Extractor::extract_sequence(Context &ctx, Extractor::Spec const &spec)
+{
+  return this->extract(ctx, spec);
+}
+
 BufferWriter &
 Extractor::format(BufferWriter &w, Spec const &spec, Context &ctx)
 {
@@ -432,6 +438,14 @@ cdr(Feature &feature)
     span.remove_prefix(1);
     feature = span.empty() ? NIL_FEATURE : cdr;
   } break;
+  case IndexFor(GENERIC):
+    // A sequence advances in place and is nil when done, so it can still be cleared.
+    if (auto gf = std::get<IndexFor(GENERIC)>(feature); gf) {
+      if (auto seq = gf->as_sequence(); seq) {
+        seq->next();
+      }
+    }
+    break;
   }
   return feature;
 }
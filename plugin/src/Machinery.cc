@@ -5,6 +5,9 @@
  * SPDX-License-Identifier: Apache-2.0
 */
 
+#include <algorithm>
+#include <limits>
+
 #include <swoc/TextView.h>
 #include <swoc/Errata.h>
 #include <swoc/BufferWriter.h>
@@ -15,6 +18,8 @@
 #include "txn_box/Context.h"
 #include "txn_box/Directive.h"
 #include "txn_box/Comparison.h"
+#include "txn_box/Stat.h"
+#include "txn_box/ShardedLRU.h"
 
 #include "txn_box/yaml_util.h"
 #include "txn_box/ts_util.h"
@@ -98,7 +103,7 @@ Do_ua_req_url_host::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // ---
@@ -168,7 +173,7 @@ Do_proxy_req_url_host::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -238,7 +243,7 @@ Do_ua_req_url_port::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   if (!expr.result_type().can_satisfy(INTEGER)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), INTEGER);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // ---
@@ -308,7 +313,7 @@ Do_proxy_req_url_port::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_
   if (!expr.result_type().can_satisfy(INTEGER)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), INTEGER);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -474,7 +479,7 @@ Do_ua_req_url_loc::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node
   if (!expr.result_type().can_satisfy({STRING, TUPLE})) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {} or a {} of 2 elements.)", KEY, drtv_node.Mark(), STRING, TUPLE);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // ---
@@ -540,7 +545,7 @@ Do_proxy_req_url_loc::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_n
   if (!expr.result_type().can_satisfy({STRING, TUPLE})) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {} or a {} of 2 elements.)", KEY, drtv_node.Mark(), STRING, TUPLE);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -613,7 +618,7 @@ Do_ua_req_host::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, s
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the port for the user agent request.
@@ -685,7 +690,7 @@ Do_ua_req_port::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, s
   if (!expr.result_type().can_satisfy(INTEGER)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), INTEGER);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 
 // ---
@@ -759,7 +764,7 @@ Do_proxy_req_port::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node
   if (!expr.result_type().can_satisfy(INTEGER)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), INTEGER);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -828,7 +833,7 @@ Do_proxy_req_host::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the location for the user agent request.
@@ -897,7 +902,7 @@ Do_ua_req_loc::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, sw
   if (!expr.result_type().can_satisfy({STRING, TUPLE})) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {} or a {}.)", KEY, drtv_node.Mark(), STRING, TUPLE);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the location for the proxy request.
@@ -966,7 +971,7 @@ Do_proxy_req_loc::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node,
   if (!expr.result_type().can_satisfy({STRING, TUPLE})) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {} or a {}.)", KEY, drtv_node.Mark(), STRING, TUPLE);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the scheme for the inbound request.
@@ -1036,7 +1041,7 @@ Do_ua_req_scheme::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node,
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the URL for the inbound request.
@@ -1106,7 +1111,7 @@ Do_ua_req_url::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, sw
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the scheme for the outbound request.
@@ -1176,7 +1181,7 @@ Do_proxy_req_scheme::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_no
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the URL for the outbound request.
@@ -1246,7 +1251,7 @@ Do_proxy_req_url::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node,
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a {}.)", KEY, drtv_node.Mark(), STRING);
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 class Do_did_remap : public Directive
@@ -1306,7 +1311,7 @@ Do_did_remap::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swo
 {
   // Default, with no value, is @c true.
   if (key_value.IsNull()) {
-    return Handle{new self_type(Expr(true))};
+    return Handle{new (cfg) self_type(Expr(true))};
   }
   auto &&[expr, errata]{cfg.parse_expr(key_value)};
   if (!errata.is_ok()) {
@@ -1316,7 +1321,7 @@ Do_did_remap::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swo
   if (!expr.result_type().can_satisfy(BOOLEAN)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be convertible to a {}.)", KEY, drtv_node.Mark(), BOOLEAN);
   }
-  return Handle{new self_type{std::move(expr)}};
+  return Handle{new (cfg) self_type{std::move(expr)}};
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -1399,9 +1404,9 @@ Do_apply_remap_rule::invoke(Context &ctx)
 }
 
 swoc::Rv<Directive::Handle>
-Do_apply_remap_rule::load(Config &, CfgStaticData const *, YAML::Node, swoc::TextView const &, swoc::TextView const &, YAML::Node)
+Do_apply_remap_rule::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::TextView const &, swoc::TextView const &, YAML::Node)
 {
-  return Handle(new self_type);
+  return Handle(new (cfg) self_type);
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the path for the request.
@@ -1473,7 +1478,7 @@ Do_ua_req_path::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, s
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the fragment for the request.
@@ -1545,7 +1550,7 @@ Do_ua_req_fragment::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the path for the request.
@@ -1615,7 +1620,7 @@ Do_proxy_req_path::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the fragment for the request.
@@ -1684,7 +1689,7 @@ Do_proxy_req_fragment::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 class FieldDirective : public Directive
@@ -1902,7 +1907,7 @@ Do_txn_debug::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swo
     errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value.Mark(), KEY, drtv_node.Mark());
     return std::move(errata);
   }
-  return {Handle{new self_type{std::move(expr)}}};
+  return {Handle{new (cfg) self_type{std::move(expr)}}};
 }
 
 // --
@@ -1954,7 +1959,7 @@ Do_ua_req_field::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::Text
                       YAML::Node key_value)
 {
   return super_type::load(
-    cfg, [](TextView const &name, Expr &&fmt) -> Handle { return Handle(new self_type(name, std::move(fmt))); }, KEY, arg,
+    cfg, [&cfg](TextView const &name, Expr &&fmt) -> Handle { return Handle(new (cfg) self_type(name, std::move(fmt))); }, KEY, arg,
     key_value);
 }
 
@@ -2006,7 +2011,7 @@ Do_proxy_req_field::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::T
                          YAML::Node key_value)
 {
   return super_type::load(
-    cfg, [](TextView const &name, Expr &&fmt) -> Handle { return Handle(new self_type(name, std::move(fmt))); }, KEY, arg,
+    cfg, [&cfg](TextView const &name, Expr &&fmt) -> Handle { return Handle(new (cfg) self_type(name, std::move(fmt))); }, KEY, arg,
     key_value);
 }
 
@@ -2058,7 +2063,7 @@ Do_proxy_rsp_field::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::T
                          YAML::Node key_value)
 {
   return super_type::load(
-    cfg, [](TextView const &name, Expr &&fmt) -> Handle { return Handle(new self_type(name, std::move(fmt))); }, KEY, arg,
+    cfg, [&cfg](TextView const &name, Expr &&fmt) -> Handle { return Handle(new (cfg) self_type(name, std::move(fmt))); }, KEY, arg,
     key_value);
 }
 
@@ -2110,7 +2115,7 @@ Do_upstream_rsp_field::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc
                             YAML::Node key_value)
 {
   return super_type::load(
-    cfg, [](TextView const &name, Expr &&fmt) -> Handle { return Handle(new self_type(name, std::move(fmt))); }, KEY, arg,
+    cfg, [&cfg](TextView const &name, Expr &&fmt) -> Handle { return Handle(new (cfg) self_type(name, std::move(fmt))); }, KEY, arg,
     key_value);
 }
 /* ------------------------------------------------------------------------------------ */
@@ -2188,7 +2193,7 @@ Do_upstream_rsp_status::load(Config &cfg, CfgStaticData const *, YAML::Node drtv
   if (!errata.is_ok()) {
     return std::move(errata);
   }
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
 
   auto expr_type = expr.result_type();
@@ -2252,7 +2257,7 @@ Do_upstream_reason::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(The value for "{}" must be a string.)", KEY, drtv_node.Mark());
   }
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
 
   self->_fmt = std::move(expr);
@@ -2331,7 +2336,7 @@ Do_proxy_rsp_status::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_no
   if (!errata.is_ok()) {
     return std::move(errata);
   }
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
 
   auto expr_type = expr.result_type();
@@ -2397,7 +2402,7 @@ Do_proxy_rsp_reason::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_no
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR, R"(The value for "{}" must be a string.)", KEY, drtv_node.Mark());
   }
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
 
   self->_expr = std::move(expr);
@@ -2471,7 +2476,7 @@ Do_proxy_rsp_body::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node
   if (!expr.result_type().can_satisfy({STRING, ActiveType::TupleOf(STRING)})) {
     return Errata(S_ERROR, R"(The value for "{}" must be a string or a list of two strings.)", KEY, drtv_node.Mark());
   }
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
 
   self->_expr = std::move(expr);
@@ -2617,7 +2622,7 @@ Do_upstream_rsp_body::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_n
     return Errata(S_ERROR, R"(The value for "{}" must be a string.)", KEY, drtv_node.Mark());
   }
 
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 // ---
 /// Immediate proxy reply.
@@ -2678,7 +2683,7 @@ protected:
   index_type _reason_idx; ///< Status reason text.
   index_type _body_idx;   ///< Body content of respons.
   /// Bounce from fixup hook directive back to @a this.
-  Directive::Handle _fixup{new LambdaDirective([this](Context &ctx) -> Errata { return this->fixup(ctx); })};
+  LambdaDirective _fixup{[this](Context &ctx) -> Errata { return this->fixup(ctx); }};
 
   Errata load_status();
 
@@ -2737,7 +2742,7 @@ Do_proxy_reply::invoke(Context &ctx)
 
   // Arrange for fixup to get invoked.
   if (need_hook_p) {
-    ctx.on_hook_do(FIXUP_HOOK, _fixup.get());
+    ctx.on_hook_do(FIXUP_HOOK, &_fixup);
   }
   return {};
 }
@@ -2783,7 +2788,7 @@ Rv<Directive::Handle>
 Do_proxy_reply::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
                      YAML::Node key_value)
 {
-  Handle handle{new self_type};
+  Handle handle{new (cfg) self_type};
   Errata errata;
   auto self = static_cast<self_type *>(handle.get());
   if (key_value.IsScalar()) {
@@ -2826,9 +2831,9 @@ public:
 };
 
 Rv<Directive::Handle>
-Do_remap_redirect::load(Config &, CfgStaticData const *, YAML::Node
+Do_remap_redirect::load(Config &cfg, CfgStaticData const *, YAML::Node
                         , swoc::TextView const &, swoc::TextView const &, YAML::Node) {
-  return Handle{new self_type};
+  return Handle{new (cfg) self_type};
 }
 
 Errata
@@ -2905,7 +2910,7 @@ protected:
   index_type _location_idx; ///< Location field value.
   index_type _body_idx;     ///< Body content of respons.
   /// Bounce from fixup hook directive back to @a this.
-  Directive::Handle _set_location{new LambdaDirective([this](Context &ctx) -> Errata { return this->fixup(ctx); })};
+  LambdaDirective _set_location{[this](Context &ctx) -> Errata { return this->fixup(ctx); }};
 
   Errata load_status();
 
@@ -2972,7 +2977,7 @@ Do_redirect::invoke(Context &ctx)
   }
   // Arrange for fixup to get invoked.
   if (need_hook_p) {
-    ctx.on_hook_do(FIXUP_HOOK, _set_location.get());
+    ctx.on_hook_do(FIXUP_HOOK, &_set_location);
   }
   return {};
 }
@@ -3029,7 +3034,7 @@ Rv<Directive::Handle>
 Do_redirect::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
                   YAML::Node key_value)
 {
-  Handle handle{new self_type};
+  Handle handle{new (cfg) self_type};
   Errata errata;
   auto self = static_cast<self_type *>(handle.get());
   if (key_value.IsScalar()) {
@@ -3077,8 +3082,12 @@ public:
 protected:
   Expr _tag;
   Expr _msg;
+  TextView _tag_text; ///< Localized C string tag if @a _tag is a literal.
 
   Do_debug(Expr &&tag, Expr &&msg);
+
+  /// Set up @a _tag_text if the tag is a literal string.
+  void localize_tag(Config &cfg);
 };
 
 const std::string Do_debug::KEY{"debug"};
@@ -3090,12 +3099,25 @@ Do_debug::Do_debug(Expr &&tag, Expr &&msg) : _tag(std::move(tag)), _msg(std::mov
 Errata
 Do_debug::invoke(Context &ctx)
 {
-  TextView tag = ctx.extract_view(_tag, {Context::EX_COMMIT, Context::EX_C_STR});
-  TextView msg = ctx.extract_view(_msg);
-  TSDebug(tag.data(), "%.*s", static_cast<int>(msg.size()), msg.data());
+  TextView tag = _tag_text.empty() ? ctx.extract_view(_tag, {Context::EX_COMMIT, Context::EX_C_STR}) : _tag_text;
+  // Don't extract the message unless it will be logged.
+  if (TSIsDebugTagSet(tag.data())) {
+    TextView msg = ctx.extract_view(_msg);
+    TSDebug(tag.data(), "%.*s", static_cast<int>(msg.size()), msg.data());
+  }
   return {};
 }
 
+void
+Do_debug::localize_tag(Config &cfg)
+{
+  if (_tag.is_literal()) {
+    if (auto view = std::get_if<IndexFor(STRING)>(&std::get<Expr::LITERAL>(_tag._raw)); view && !view->empty()) {
+      _tag_text = cfg.localize(*view, Config::LOCAL_CSTR);
+    }
+  }
+}
+
 Rv<Directive::Handle>
 Do_debug::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
                YAML::Node key_value)
@@ -3106,7 +3128,9 @@ Do_debug::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::T
       msg_errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value.Mark(), KEY, drtv_node.Mark());
       return {{}, std::move(msg_errata)};
     }
-    return {Handle{new self_type{Expr{Config::PLUGIN_TAG}, std::move(msg_fmt)}}, {}};
+    auto self = new (cfg) self_type{Expr{Config::PLUGIN_TAG}, std::move(msg_fmt)};
+    self->localize_tag(cfg);
+    return {Handle{self}, {}};
   } else if (key_value.IsSequence()) {
     if (key_value.size() > 2) {
       return Errata(S_ERROR, R"(Value for "{}" key at {} is not a list of two strings as required.)", KEY, key_value.Mark());
@@ -3123,7 +3147,9 @@ Do_debug::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::T
       tag_errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value[1].Mark(), KEY, drtv_node.Mark());
       return std::move(tag_errata);
     }
-    return Handle(new self_type(std::move(tag_expr), std::move(msg_expr)));
+    auto self = new (cfg) self_type(std::move(tag_expr), std::move(msg_expr));
+    self->localize_tag(cfg);
+    return Handle(self);
   }
   return Errata(S_ERROR, R"(Value for "{}" key at {} is not a string or a list of strings as required.)", KEY, key_value.Mark());
 }
@@ -3171,7 +3197,7 @@ Do_error::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::T
     msg_errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value.Mark(), KEY, drtv_node.Mark());
     return {{}, std::move(msg_errata)};
   }
-  return {Handle{new self_type{std::move(msg_fmt)}}};
+  return {Handle{new (cfg) self_type{std::move(msg_fmt)}}};
 }
 
 /// Log an notify message.
@@ -3225,7 +3251,7 @@ Do_note::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::Te
     msg_errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value.Mark(), KEY, drtv_node.Mark());
     return std::move(msg_errata);
   }
-  return Handle{new self_type{std::move(msg_fmt)}};
+  return Handle{new (cfg) self_type{std::move(msg_fmt)}};
 }
 // -- doc note::load
 
@@ -3271,7 +3297,7 @@ Do_warning::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc:
     msg_errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value.Mark(), KEY, drtv_node.Mark());
     return {{}, std::move(msg_errata)};
   }
-  return {Handle{new self_type{std::move(msg_fmt)}}};
+  return {Handle{new (cfg) self_type{std::move(msg_fmt)}}};
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -3325,7 +3351,7 @@ Do_cache_key::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::TextVie
     return std::move(errata);
   }
 
-  return Handle(new self_type(std::move(fmt)));
+  return Handle(new (cfg) self_type(std::move(fmt)));
 }
 /* ------------------------------------------------------------------------------------ */
 /// Set a transaction configuration variable override.
@@ -3399,7 +3425,7 @@ Do_txn_conf::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::TextView
     return std::move(errata);
   }
 
-  return Handle(new self_type(std::move(fmt), txn_var));
+  return Handle(new (cfg) self_type(std::move(fmt), txn_var));
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -3459,7 +3485,7 @@ Do_upstream_addr::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::Tex
     return Errata(S_ERROR, R"(Value for "{}" must be an IP address.)");
   }
 
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /// Set a transaction local variable.
@@ -3513,7 +3539,7 @@ Do_var::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc::TextView cons
     return std::move(errata);
   }
 
-  return Handle(new self_type(cfg.localize(arg), std::move(expr)));
+  return Handle(new (cfg) self_type(cfg.localize(arg), std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /// Internal transaction error control
@@ -3555,7 +3581,7 @@ Do_txn_error::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swo
     errata.note(R"(While parsing message at {} for "{}" directive at {}.)", key_value.Mark(), KEY, drtv_node.Mark());
     return {std::move(errata)};
   }
-  return {Handle{new self_type{std::move(expr)}}};
+  return {Handle{new (cfg) self_type{std::move(expr)}}};
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -3573,6 +3599,10 @@ public:
   static const std::string SELECT_KEY;
   static const std::string FOR_EACH_KEY;
   static const std::string CONTINUE_KEY;
+  static const std::string CACHE_KEY;
+  static const std::string CACHE_SIZE_KEY;
+  static const std::string CACHE_HIT_STAT_KEY;
+  static const std::string CACHE_MISS_STAT_KEY;
   static const HookMask HOOKS; ///< Valid hooks for directive.
 
   Errata invoke(Context &ctx) override;
@@ -3599,6 +3629,7 @@ protected:
     struct {
       unsigned for_each_p : 1; ///< Direct action is per tuple element.
       unsigned continue_p : 1; ///< Continue with directives after this - want default to be 0.
+      unsigned sequence_p : 1; ///< Comparisons accept a feature sequence.
     } f;
   } _opt;
 
@@ -3610,15 +3641,44 @@ protected:
   using CaseGroup = std::vector<Case>;
   CaseGroup _cases; ///< List of cases for the select.
 
+  /** Cache of feature value to selected case index.
+   *
+   * The cached value is the index of the matching case, or the number of cases if no case matched.
+   */
+  using SelectCache = ShardedLRU<unsigned>;
+
+  std::unique_ptr<SelectCache> _cache; ///< Selection cache, if enabled.
+  Stat _cache_hit;                     ///< Statistic for cache hits.
+  Stat _cache_miss;                    ///< Statistic for cache misses.
+
   Do_with() = default;
 
+  /** Find the matching case.
+   *
+   * @param ctx Runtime context.
+   * @param feature Feature to compare.
+   * @return The index of the matching case, or the number of cases if none matched.
+   */
+  unsigned select(Context &ctx, Feature const &feature);
+
+  /// @return The sequence in @a feature, or @c nullptr if it is not a sequence.
+  static FeatureSequence *as_sequence(Feature const &feature);
+
+  /// @return A tuple of the elements of @a seq.
+  static Feature tuple_of(Context &ctx, FeatureSequence &seq);
+
   Errata load_case(Config &cfg, YAML::Node node);
+  Errata load_cache(Config &cfg, YAML::Node node);
 };
 
 const std::string Do_with::KEY{"with"};
 const std::string Do_with::SELECT_KEY{"select"};
 const std::string Do_with::FOR_EACH_KEY{"for-each"};
 const std::string Do_with::CONTINUE_KEY{"continue"};
+const std::string Do_with::CACHE_KEY{"cache"};
+const std::string Do_with::CACHE_SIZE_KEY{"size"};
+const std::string Do_with::CACHE_HIT_STAT_KEY{"hit-stat"};
+const std::string Do_with::CACHE_MISS_STAT_KEY{"miss-stat"};
 
 const HookMask Do_with::HOOKS{MaskFor({Hook::POST_LOAD, Hook::TXN_START, Hook::CREQ, Hook::PREQ, Hook::URSP, Hook::PRSP,
                                        Hook::PRE_REMAP, Hook::POST_REMAP, Hook::REMAP})};
@@ -3626,10 +3686,12 @@ const HookMask Do_with::HOOKS{MaskFor({Hook::POST_LOAD, Hook::TXN_START, Hook::C
 Errata
 Do_with::invoke(Context &ctx)
 {
-  Feature feature{ctx.extract(_expr)};
+  // Iteration and list comparisons don't need the elements generated up front.
+  Feature feature{(_opt.f.for_each_p || _opt.f.sequence_p) ? ctx.extract_sequence(_expr) : ctx.extract(_expr)};
   ctx.commit(feature);
   Feature save{ctx._active};
   ctx._active = feature;
+  auto seq    = as_sequence(feature);
 
   if (_do) {
     if (_opt.f.for_each_p) {
@@ -3643,9 +3705,16 @@ Do_with::invoke(Context &ctx)
       clear(feature);
       ctx._active_ext = NIL_FEATURE;
       // Iteration can potentially modify the extracted feature value, so if there are comparisons
-      // reset the feature.
+      // reset the feature. A sequence reads the current values when rewound.
       if (!_cases.empty()) {
-        ctx._active = feature = ctx.extract(_expr);
+        if (seq && _opt.f.sequence_p) {
+          seq->rewind();
+          feature = static_cast<Generic *>(seq);
+        } else {
+          feature = _opt.f.sequence_p ? ctx.extract_sequence(_expr) : ctx.extract(_expr);
+          seq     = as_sequence(feature);
+        }
+        ctx._active = feature;
       }
     } else {
       ctx.mark_terminal(false);
@@ -3654,14 +3723,15 @@ Do_with::invoke(Context &ctx)
   }
 
   ctx.mark_terminal(false); // default is continue on.
-  for (auto const &c : _cases) {
-    if (!c._cmp || (*c._cmp)(ctx, feature)) {
-      if (c._do) {
-        c._do->invoke(ctx);
+  if (auto idx = this->select(ctx, feature); idx < _cases.size()) {
+    if (auto const &c = _cases[idx]; c._do) {
+      // The case directives see the full list, not the sequence.
+      if (seq) {
+        ctx._active = this->tuple_of(ctx, *seq);
       }
-      ctx.mark_terminal(!_opt.f.continue_p); // successful compare, mark terminal.
-      break;
+      c._do->invoke(ctx);
     }
+    ctx.mark_terminal(!_opt.f.continue_p); // successful compare, mark terminal.
   }
   // Need to restore to previous state if nothing matched.
   clear(ctx._active);
@@ -3669,6 +3739,65 @@ Do_with::invoke(Context &ctx)
   return {};
 }
 
+FeatureSequence *
+Do_with::as_sequence(Feature const &feature)
+{
+  if (auto gf = std::get_if<IndexFor(GENERIC)>(&feature); gf && *gf) {
+    return (*gf)->as_sequence();
+  }
+  return nullptr;
+}
+
+Feature
+Do_with::tuple_of(Context &ctx, FeatureSequence &seq)
+{
+  unsigned n = 0;
+  for (seq.rewind(); !seq.is_nil(); seq.next()) {
+    ++n;
+  }
+  auto span = ctx.alloc_span<Feature>(n);
+  seq.rewind();
+  for (auto &item : span) {
+    item = seq.extract();
+    seq.next();
+  }
+  return span;
+}
+
+unsigned
+Do_with::select(Context &ctx, Feature const &feature)
+{
+  unsigned n   = _cases.size();
+  bool cache_p = _cache && IndexFor(STRING) == feature.index();
+  TextView key;
+
+  if (cache_p) {
+    key = std::get<IndexFor(STRING)>(feature);
+    unsigned idx = n;
+    if (_cache->find(key, [&](unsigned cached) -> bool { return (idx = cached) <= n; })) {
+      // The comparisons are pure so the cached case is certain to match, but it must be invoked
+      // to update the context capture state for use by the case directives.
+      if (idx == n || !_cases[idx]._cmp || (*_cases[idx]._cmp)(ctx, feature)) {
+        _cache_hit.update(1);
+        return idx;
+      }
+    }
+    _cache_miss.update(1);
+  }
+
+  unsigned idx = 0;
+  for (; idx < n; ++idx) {
+    if (auto const &c = _cases[idx]; !c._cmp || (*c._cmp)(ctx, feature)) {
+      break;
+    }
+  }
+
+  if (cache_p) {
+    _cache->insert(key, unsigned{idx});
+  }
+  return idx;
+}
+
 swoc::Rv<Directive::Handle>
 Do_with::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
               YAML::Node key_value)
@@ -3680,7 +3809,7 @@ Do_with::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::Te
     return std::move(errata);
   }
 
-  auto *self = new self_type;
+  auto *self = new (cfg) self_type;
   Handle handle(self); // for return, and cleanup in case of error.
   self->_expr  = std::move(expr);
   auto f_scope = cfg.feature_scope(self->_expr.result_type());
@@ -3712,6 +3841,15 @@ Do_with::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::Te
     self->_opt.f.continue_p = true;
   }
 
+  YAML::Node cache_node{drtv_node[CACHE_KEY]};
+  if (cache_node) {
+    errata = self->load_cache(cfg, cache_node);
+    if (!errata.is_ok()) {
+      errata.note(R"(While parsing "{}" key at {} in "{}" directive at {}.)", CACHE_KEY, cache_node.Mark(), KEY, drtv_node.Mark());
+      return std::move(errata);
+    }
+  }
+
   YAML::Node do_node{drtv_node[DO_KEY]};
   YAML::Node for_each_node{drtv_node[FOR_EACH_KEY]};
   if (do_node && for_each_node) {
@@ -3734,6 +3872,12 @@ Do_with::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::Te
       return std::move(errata);
     }
   }
+
+  // If the active feature is used only by list comparisons, it doesn't need to be a tuple.
+  if (!self->_cases.empty() && (!self->_do || self->_opt.f.for_each_p)) {
+    self->_opt.f.sequence_p = std::all_of(self->_cases.begin(), self->_cases.end(),
+                                          [](Case const &c) { return !c._cmp || c._cmp->accepts_sequence(); });
+  }
   return handle;
 }
 
@@ -3765,7 +3909,7 @@ Do_with::load_case(Config &cfg, YAML::Node node)
         return std::move(errata);
       }
     } else {
-      c._do.reset(new NilDirective);
+      c._do.reset(new (cfg) NilDirective);
     }
     // Everything is fine, update the case load and return.
     _cases.emplace_back(std::move(c));
@@ -3774,6 +3918,47 @@ Do_with::load_case(Config &cfg, YAML::Node node)
   return Errata(S_ERROR, R"(The value at {} for "{}" is not an object as required.")", node.Mark(), SELECT_KEY);
 }
 
+Errata
+Do_with::load_cache(Config &cfg, YAML::Node node)
+{
+  YAML::Node size_node{node};
+  if (node.IsMap()) {
+    size_node = node[CACHE_SIZE_KEY];
+    if (!size_node) {
+      return Errata(S_ERROR, R"("{}" key is required.)", CACHE_SIZE_KEY);
+    }
+    if (auto stat_node = node[CACHE_HIT_STAT_KEY]; stat_node) {
+      _cache_hit.assign(cfg, stat_node.Scalar());
+    }
+    if (auto stat_node = node[CACHE_MISS_STAT_KEY]; stat_node) {
+      _cache_miss.assign(cfg, stat_node.Scalar());
+    }
+  }
+
+  if (!size_node.IsScalar()) {
+    return Errata(S_ERROR, R"(Cache size at {} must be a positive integer.)", size_node.Mark());
+  }
+  TextView text{size_node.Scalar()};
+  TextView parsed;
+  auto size = swoc::svtou(text, &parsed);
+  if (parsed.size() != text.size() || size == 0) {
+    return Errata(S_ERROR, R"(Cache size "{}" at {} must be a positive integer.)", text, size_node.Mark());
+  }
+
+  // Caching is valid only if the selected case depends on nothing but the feature.
+  for (auto const &c : _cases) {
+    if (c._cmp && !c._cmp->is_pure()) {
+      return Errata(S_ERROR, R"(Selection cannot be cached because a comparison is not a pure function of the feature.)");
+    }
+  }
+  if (!_expr.result_type().can_satisfy(STRING)) {
+    return Errata(S_ERROR, R"(Selection cannot be cached because the feature is not a string.)");
+  }
+
+  _cache.reset(new SelectCache(size));
+  return {};
+}
+
 /* ------------------------------------------------------------------------------------ */
 const std::string When::KEY{"when"};
 const HookMask When::HOOKS{
@@ -3801,7 +3986,7 @@ When::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextV
       cfg._hook = save;
       if (do_errata.is_ok()) {
         cfg.reserve_slot(hook);
-        return {Handle{new self_type{hook, std::move(do_handle)}}, {}};
+        return {Handle{new (cfg) self_type{hook, std::move(do_handle)}}, {}};
       } else {
         zret.note(do_errata);
         zret.note(R"(Failed to load directive in "{}" at {} in "{}" directive at {}.)", DO_KEY, do_node.Mark(), KEY,
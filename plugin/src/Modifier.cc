@@ -4,6 +4,17 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include <swoc/bwf_base.h>
+#include <swoc/Lexicon.h>
+
 #include "txn_box/Modifier.h"
 #include "txn_box/Context.h"
 #include "txn_box/Config.h"
@@ -15,6 +26,12 @@ using swoc::Errata;
 using swoc::Rv;
 using namespace swoc::literals;
 
+void *
+Modifier::operator new(size_t n, Config &cfg)
+{
+  return cfg.allocate_cfg_storage(n, alignof(std::max_align_t)).data();
+}
+
 Errata
 Modifier::define(swoc::TextView name, Modifier::Worker const &f)
 {
@@ -136,12 +153,11 @@ Mod_hash::result_type(ActiveType const &) const
 Rv<Feature>
 Mod_hash::operator()(Context &, feature_type_for<STRING> feature)
 {
-  feature_type_for<INTEGER> value = std::hash<std::string_view>{}(feature);
-  return Feature{feature_type_for<INTEGER>{value % _n}};
+  return Feature{feature_type_for<INTEGER>(Hash64Wy(feature) % _n)};
 }
 
 Rv<Modifier::Handle>
-Mod_hash::load(Config &, YAML::Node node, TextView, TextView, YAML::Node key_value)
+Mod_hash::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
 {
   if (!key_value.IsScalar()) {
     return Errata(S_ERROR, R"(Value for "{}" at {} in modifier at {} is not a number as required.)", KEY, key_value.Mark(), node.Mark());
@@ -157,11 +173,447 @@ Mod_hash::load(Config &, YAML::Node node, TextView, TextView, YAML::Node key_val
     return Errata(S_ERROR, R"(Value "{}" for "{}" at {} in modifier at {} must be at least 2.)", src, KEY, key_value.Mark(), node.Mark());
   }
 
-  return {Handle{new self_type(n)}, {}};
+  return {Handle{new (cfg) self_type(n)}, {}};
+}
+
+// ---
+
+/** Stable hashes and digests.
+ *
+ * The output is the same on every build and platform, so it can be used for cache keys, sharding
+ * and signatures that are checked elsewhere. The cryptographic digests use OpenSSL, which selects
+ * the hardware accelerated implementation for the CPU.
+ */
+class Mod_digest : public Modifier
+{
+  using self_type  = Mod_digest;
+  using super_type = Modifier;
+
+public:
+  static inline const std::string KEY{"digest"};              ///< Identifier name.
+  static inline const std::string ALGORITHM_TAG{"algorithm"}; ///< Algorithm key.
+  static inline const std::string FORMAT_TAG{"format"};       ///< Output format key.
+  static inline const std::string SECRET_TAG{"secret"};       ///< HMAC secret key.
+  static inline const std::string SEED_TAG{"seed"};           ///< Hash seed key.
+
+  /** Modify the feature.
+   *
+   * @param ctx Run time context.
+   * @param feature Feature to modify.
+   * @return Errors, if any.
+   */
+  Rv<Feature> operator()(Context &ctx, feature_type_for<STRING> feature) override;
+
+  /** Check if @a ftype is a valid type to be modified.
+   *
+   * @param ex_type Type of feature to modify.
+   * @return @c true if this modifier can modity that feature type, @c false if not.
+   */
+  bool is_valid_for(ActiveType const &ex_type) const override;
+
+  /// Resulting type of feature after modifying.
+  ActiveType result_type(ActiveType const &) const override;
+
+  /** Create an instance from YAML config.
+   *
+   * @param cfg Configuration state object.
+   * @param mod_node Node with modifier.
+   * @param key_node Node in @a mod_node that identifies the modifier.
+   * @return A constructed instance or errors.
+   */
+  static Rv<Handle> load(Config &cfg, YAML::Node node, TextView key, TextView arg, YAML::Node key_value);
+
+protected:
+  enum Algorithm { INVALID_ALG, WYHASH, FNV1A, SHA1, SHA256, SHA512, HMAC_SHA1, HMAC_SHA256, HMAC_SHA512 };
+  enum Format { INVALID_FMT, HEX, BASE64, BASE64URL, INTEGER_FMT };
+
+  inline static const swoc::Lexicon<Algorithm> AlgorithmNames{{{WYHASH, "wyhash"},
+                                                               {FNV1A, "fnv1a"},
+                                                               {SHA1, "sha1"},
+                                                               {SHA256, "sha256"},
+                                                               {SHA512, "sha512"},
+                                                               {HMAC_SHA1, "hmac-sha1"},
+                                                               {HMAC_SHA256, "hmac-sha256"},
+                                                               {HMAC_SHA512, "hmac-sha512"}},
+                                                              INVALID_ALG};
+  inline static const swoc::Lexicon<Format> FormatNames{
+    {{HEX, "hex"}, {BASE64, "base64"}, {BASE64URL, "base64url"}, {INTEGER_FMT, "integer"}},
+    INVALID_FMT};
+
+  Algorithm _alg = WYHASH; ///< Hash algorithm.
+  Format _fmt    = HEX;    ///< Output format.
+  uint64_t _seed = 0;      ///< Seed for the non-cryptographic hashes.
+  Expr _secret;            ///< Secret for HMAC.
+
+  /// Constructor for @c load.
+  Mod_digest() = default;
+
+  /// OpenSSL digest for @a alg, @c nullptr for the non-cryptographic hashes.
+  static EVP_MD const *md_for(Algorithm alg);
+};
+
+bool
+Mod_digest::is_valid_for(ActiveType const &ex_type) const
+{
+  return ex_type.can_satisfy(STRING);
+}
+
+ActiveType
+Mod_digest::result_type(ActiveType const &) const
+{
+  return _fmt == INTEGER_FMT ? ActiveType{NIL, INTEGER} : ActiveType{NIL, STRING};
+}
+
+EVP_MD const *
+Mod_digest::md_for(Algorithm alg)
+{
+  switch (alg) {
+  case SHA1:
+  case HMAC_SHA1:
+    return EVP_sha1();
+  case SHA256:
+  case HMAC_SHA256:
+    return EVP_sha256();
+  case SHA512:
+  case HMAC_SHA512:
+    return EVP_sha512();
+  default:
+    break;
+  }
+  return nullptr;
+}
+
+Rv<Feature>
+Mod_digest::operator()(Context &ctx, feature_type_for<STRING> feature)
+{
+  std::array<unsigned char, EVP_MAX_MD_SIZE> raw;
+  unsigned n = 0;
+
+  if (_alg == WYHASH || _alg == FNV1A) {
+    uint64_t h = _alg == WYHASH ? Hash64Wy(feature, _seed) : Hash64FNV1a(feature, _seed);
+    if (_fmt == INTEGER_FMT) {
+      return Feature{feature_type_for<INTEGER>(h & std::numeric_limits<int64_t>::max())};
+    }
+    for (n = 0; n < sizeof(h); ++n) { // big endian, so hex output matches the integer.
+      raw[n] = h >> (56 - 8 * n);
+    }
+  } else if (_alg == HMAC_SHA1 || _alg == HMAC_SHA256 || _alg == HMAC_SHA512) {
+    auto secret = ctx.extract_view(_secret);
+    if (nullptr == HMAC(md_for(_alg), secret.data(), secret.size(), reinterpret_cast<unsigned char const *>(feature.data()),
+                        feature.size(), raw.data(), &n)) {
+      return NIL_FEATURE;
+    }
+  } else if (!EVP_Digest(feature.data(), feature.size(), raw.data(), &n, md_for(_alg), nullptr)) {
+    return NIL_FEATURE;
+  }
+
+  TextView bytes{reinterpret_cast<char const *>(raw.data()), n};
+  switch (_fmt) {
+  case INTEGER_FMT: {
+    uint64_t v = 0;
+    for (unsigned i = 0; i < 8 && i < n; ++i) {
+      v = (v << 8) | raw[i];
+    }
+    return Feature{feature_type_for<INTEGER>(v & std::numeric_limits<int64_t>::max())};
+  }
+  case BASE64:
+  case BASE64URL: {
+    auto span = ctx.alloc_span<char>(base64_encoded_size(n, _fmt == BASE64URL));
+    base64_encode(span, bytes, _fmt == BASE64URL);
+    return {FeatureView::Literal(TextView{span.data(), span.size()})};
+  }
+  default:
+    break;
+  }
+  static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+  auto span                         = ctx.alloc_span<char>(2 * n);
+  for (unsigned i = 0; i < n; ++i) {
+    span[2 * i]     = HEX_DIGITS[raw[i] >> 4];
+    span[2 * i + 1] = HEX_DIGITS[raw[i] & 0xF];
+  }
+  return {FeatureView::Literal(TextView{span.data(), span.size()})};
+}
+
+Rv<Modifier::Handle>
+Mod_digest::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
+{
+  auto self = new (cfg) self_type;
+  Handle handle(self);
+
+  YAML::Node alg_node = key_value;
+  if (key_value.IsMap()) {
+    alg_node = key_value[ALGORITHM_TAG];
+    if (!alg_node) {
+      return Errata(S_ERROR, R"("{}" modifier at {} must have an "{}" key.)", KEY, node.Mark(), ALGORITHM_TAG);
+    }
+  }
+  if (!alg_node.IsScalar()) {
+    return Errata(S_ERROR, R"(Algorithm for "{}" modifier at {} must be a string.)", KEY, alg_node.Mark());
+  }
+  self->_alg = AlgorithmNames[TextView{alg_node.Scalar()}];
+  if (self->_alg == INVALID_ALG) {
+    return Errata(S_ERROR, R"(Algorithm "{}" for "{}" modifier at {} is not supported.)", alg_node.Scalar(), KEY, alg_node.Mark());
+  }
+  if (self->_alg == FNV1A) {
+    self->_seed = 0xcbf29ce484222325ULL; // standard FNV-1a offset basis.
+  }
+  bool hmac_p = self->_alg == HMAC_SHA1 || self->_alg == HMAC_SHA256 || self->_alg == HMAC_SHA512;
+
+  if (!key_value.IsMap()) {
+    if (hmac_p) {
+      return Errata(S_ERROR, R"(Algorithm "{}" for "{}" modifier at {} requires a "{}" key.)", alg_node.Scalar(), KEY,
+                    alg_node.Mark(), SECRET_TAG);
+    }
+    return handle;
+  }
+
+  if (auto fmt_node = key_value[FORMAT_TAG]; fmt_node) {
+    self->_fmt = fmt_node.IsScalar() ? FormatNames[TextView{fmt_node.Scalar()}] : INVALID_FMT;
+    if (self->_fmt == INVALID_FMT) {
+      return Errata(S_ERROR, R"("{}" value at {} must be one of "hex", "base64", "base64url" or "integer".)", FORMAT_TAG,
+                    fmt_node.Mark());
+    }
+  }
+
+  if (auto secret_node = key_value[SECRET_TAG]; secret_node) {
+    if (!hmac_p) {
+      return Errata(S_ERROR, R"("{}" key at {} is valid only for HMAC algorithms.)", SECRET_TAG, secret_node.Mark());
+    }
+    auto &&[expr, errata]{cfg.parse_expr(secret_node)};
+    if (!errata.is_ok()) {
+      errata.note(R"(While parsing "{}" value for "{}" modifier at {}.)", SECRET_TAG, KEY, node.Mark());
+      return std::move(errata);
+    }
+    self->_secret = std::move(expr);
+  } else if (hmac_p) {
+    return Errata(S_ERROR, R"(Algorithm "{}" for "{}" modifier at {} requires a "{}" key.)", alg_node.Scalar(), KEY, node.Mark(),
+                  SECRET_TAG);
+  }
+
+  if (auto seed_node = key_value[SEED_TAG]; seed_node) {
+    if (self->_alg != WYHASH && self->_alg != FNV1A) {
+      return Errata(S_ERROR, R"("{}" key at {} is valid only for "wyhash" and "fnv1a".)", SEED_TAG, seed_node.Mark());
+    }
+    TextView src{seed_node.Scalar()}, parsed;
+    src.trim_if(&isspace);
+    auto seed = swoc::svtou(src, &parsed);
+    if (src.empty() || src.size() != parsed.size()) {
+      return Errata(S_ERROR, R"("{}" value "{}" at {} is not a number as required.)", SEED_TAG, src, seed_node.Mark());
+    }
+    self->_seed = seed;
+  }
+
+  return handle;
 }
 
 // ---
 
+/** Consistent hashing.
+ *
+ * The key is mapped to one of a weighted list of members using a Maglev lookup table. The table is
+ * computed during configuration load so the run time cost is a hash and an array lookup. Changing
+ * the member list moves only a small fraction of keys, in contrast to @c Mod_hash.
+ */
+class Mod_consistent_hash : public Modifier
+{
+  using self_type  = Mod_consistent_hash;
+  using super_type = Modifier;
+
+public:
+  static inline const std::string KEY{"consistent-hash"}; ///< Identifier name.
+  static inline const std::string MEMBER_TAG{"member"};   ///< Member key.
+  static inline const std::string WEIGHT_TAG{"weight"};   ///< Member weight key.
+
+  /// Maximum number of members.
+  static constexpr size_t MAX_MEMBERS = std::numeric_limits<uint16_t>::max();
+
+  /** Modify the feature.
+   *
+   * @param ctx Run time context.
+   * @param feature Feature to modify.
+   * @return Errors, if any.
+   */
+  Rv<Feature> operator()(Context &ctx, feature_type_for<STRING> feature) override;
+
+  /** Check if @a ftype is a valid type to be modified.
+   *
+   * @param ex_type Type of feature to modify.
+   * @return @c true if this modifier can modity that feature type, @c false if not.
+   */
+  bool is_valid_for(ActiveType const &ex_type) const override;
+
+  /// Resulting type of feature after modifying.
+  ActiveType result_type(ActiveType const &) const override;
+
+  /** Create an instance from YAML config.
+   *
+   * @param cfg Configuration state object.
+   * @param mod_node Node with modifier.
+   * @param key_node Node in @a mod_node that identifies the modifier.
+   * @return A constructed instance or errors.
+   */
+  static Rv<Handle> load(Config &cfg, YAML::Node node, TextView key, TextView arg, YAML::Node key_value);
+
+protected:
+  swoc::MemSpan<Feature> _members; ///< Member values.
+  swoc::MemSpan<uint16_t> _table;  ///< Lookup table of member indices.
+  ActiveType _type;                ///< Union of member types.
+
+  /// Constructor for @c load.
+  Mod_consistent_hash() = default;
+
+  /** Fill the lookup table.
+   *
+   * @param names Rendered member names, used to compute the member permutations.
+   * @param weights Member weights.
+   */
+  void build(std::vector<std::string> const &names, std::vector<unsigned> const &weights);
+
+  /// Smallest prime not less than @a n.
+  static size_t prime_at_least(size_t n);
+};
+
+bool
+Mod_consistent_hash::is_valid_for(ActiveType const &ex_type) const
+{
+  return ex_type.can_satisfy(STRING);
+}
+
+ActiveType
+Mod_consistent_hash::result_type(ActiveType const &) const
+{
+  return _type;
+}
+
+Rv<Feature>
+Mod_consistent_hash::operator()(Context &, feature_type_for<STRING> feature)
+{
+  return _members[_table[Hash64FNV1a(feature) % _table.count()]];
+}
+
+size_t
+Mod_consistent_hash::prime_at_least(size_t n)
+{
+  auto is_prime = [](size_t k) -> bool {
+    if (k < 2) {
+      return false;
+    }
+    for (size_t d = 2; d * d <= k; ++d) {
+      if (k % d == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+  while (!is_prime(n)) {
+    ++n;
+  }
+  return n;
+}
+
+void
+Mod_consistent_hash::build(std::vector<std::string> const &names, std::vector<unsigned> const &weights)
+{
+  static constexpr uint16_t EMPTY = std::numeric_limits<uint16_t>::max();
+  auto const n     = names.size();
+  auto const m     = _table.count();
+  unsigned max_wt  = *std::max_element(weights.begin(), weights.end());
+
+  // Each member has a permutation of the table slots defined by an offset and a skip. Members take
+  // turns claiming the next unclaimed slot in their permutation, with the number of turns in
+  // proportion to their weight.
+  std::vector<size_t> offset(n), skip(n), next(n, 0);
+  std::vector<unsigned> credit(n, 0);
+  for (size_t idx = 0; idx < n; ++idx) {
+    offset[idx] = Hash64FNV1a(names[idx]) % m;
+    skip[idx]   = Hash64FNV1a(names[idx], 0x84222325cbf29ce4ULL) % (m - 1) + 1;
+  }
+
+  std::fill(_table.begin(), _table.end(), EMPTY);
+  for (size_t filled = 0; filled < m;) {
+    for (size_t idx = 0; idx < n && filled < m; ++idx) {
+      credit[idx] += weights[idx];
+      if (credit[idx] < max_wt) {
+        continue;
+      }
+      credit[idx] -= max_wt;
+      size_t slot;
+      do {
+        slot = (offset[idx] + next[idx] * skip[idx]) % m;
+        ++next[idx];
+      } while (_table[slot] != EMPTY);
+      _table[slot] = idx;
+      ++filled;
+    }
+  }
+}
+
+Rv<Modifier::Handle>
+Mod_consistent_hash::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
+{
+  if (!key_value.IsSequence() || key_value.size() < 1) {
+    return Errata(S_ERROR, R"(Value for "{}" at {} in modifier at {} must be a non-empty list of members.)", KEY, key_value.Mark(),
+                  node.Mark());
+  }
+  if (key_value.size() > MAX_MEMBERS) {
+    return Errata(S_ERROR, R"(Value for "{}" at {} in modifier at {} has more than {} members.)", KEY, key_value.Mark(), node.Mark(),
+                  MAX_MEMBERS);
+  }
+
+  auto self = new (cfg) self_type;
+  Handle handle(self);
+  self->_members = cfg.alloc_span<Feature>(key_value.size());
+  std::vector<std::string> names;
+  std::vector<unsigned> weights;
+  names.reserve(key_value.size());
+  weights.reserve(key_value.size());
+
+  unsigned idx = 0;
+  for (auto child : key_value) {
+    YAML::Node member_node = child;
+    unsigned weight        = 1;
+    if (child.IsMap()) {
+      member_node = child[MEMBER_TAG];
+      if (!member_node) {
+        return Errata(S_ERROR, R"(Member at {} for "{}" modifier at {} must have a "{}" key.)", child.Mark(), KEY, node.Mark(),
+                      MEMBER_TAG);
+      }
+      if (auto weight_node = child[WEIGHT_TAG]; weight_node) {
+        TextView src{weight_node.Scalar()}, parsed;
+        src.trim_if(&isspace);
+        weight = swoc::svtou(src, &parsed);
+        if (src.empty() || src.size() != parsed.size() || weight == 0) {
+          return Errata(S_ERROR, R"(Weight "{}" at {} for "{}" modifier at {} is not a positive integer as required.)", src,
+                        weight_node.Mark(), KEY, node.Mark());
+        }
+      }
+    }
+
+    auto &&[expr, errata]{cfg.parse_expr(member_node)};
+    if (!errata.is_ok()) {
+      errata.note(R"(While parsing member at {} for "{}" modifier at {}.)", member_node.Mark(), KEY, node.Mark());
+      return std::move(errata);
+    }
+    if (!expr.is_literal()) {
+      return Errata(S_ERROR, R"(Member at {} for "{}" modifier at {} must be a literal.)", member_node.Mark(), KEY, node.Mark());
+    }
+
+    Feature &member = self->_members[idx++];
+    new (&member) Feature(std::get<Expr::LITERAL>(expr._raw));
+    self->_type |= member.value_type();
+    std::string name;
+    swoc::bwprint(name, "{}", member);
+    names.emplace_back(std::move(name));
+    weights.push_back(weight);
+  }
+
+  // Maglev needs the table to be much larger than the number of members for good balance.
+  self->_table = cfg.alloc_span<uint16_t>(prime_at_least(std::max<size_t>(1009, 100 * names.size())));
+  self->build(names, weights);
+
+  return handle;
+}
+
 /// Do replacement based on regular expression matching.
 class Mod_rxp_replace : public Modifier {
   using self_type = Mod_rxp_replace;
@@ -240,7 +692,7 @@ Mod_rxp_replace::load(Config &cfg, YAML::Node node, TextView, TextView args, YAM
     return std::move(rep_errata);
   }
 
-  auto self = new self_type(std::move(op), std::move(rep));
+  auto self = new (cfg) self_type(std::move(op), std::move(rep));
   self->_global_p = global_p;
   return {Handle(self)};
 }
@@ -408,9 +860,9 @@ Mod_filter::operator()(Context &ctx, Feature &feature)
 {
   Feature zret;
   if (feature.is_list()) {
-    auto src    = std::get<IndexFor(TUPLE)>(feature);
-    auto farray = static_cast<Feature *>(alloca(sizeof(Feature) * src.count()));
-    feature_type_for<TUPLE> dst{farray, src.count()};
+    auto src = std::get<IndexFor(TUPLE)>(feature);
+    // Build the result in place - at most every element is kept, so this is big enough.
+    auto dst         = ctx.alloc_span<Feature>(src.count());
     unsigned dst_idx = 0;
     for (Feature f = feature; !is_nil(f); f = cdr(f)) {
       Feature item  = car(f);
@@ -427,11 +879,7 @@ Mod_filter::operator()(Context &ctx, Feature &feature)
         break;
       }
     }
-    auto span = ctx.alloc_span<Feature>(dst_idx);
-    for (unsigned idx = 0; idx < dst_idx; ++idx) {
-      span[idx] = dst[idx];
-    }
-    zret = span;
+    zret = dst.subspan(0, dst_idx);
   } else {
     auto c        = this->compare(ctx, feature);
     Action action = c ? c->_action : DROP;
@@ -515,7 +963,7 @@ Mod_filter::Case::operator()(Context &ctx, Feature const &feature)
 Rv<Modifier::Handle>
 Mod_filter::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
 {
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
   auto active_type = cfg.active_type();
   auto scope{cfg.feature_scope(active_type.can_satisfy(TUPLE) ? active_type.tuple_types() : active_type)};
@@ -597,7 +1045,7 @@ Mod_else::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node key_value
     errata.note(R"(While parsing "{}" modifier at {}.)", KEY, key_value.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(fmt)});
+  return Handle(new (cfg) self_type{std::move(fmt)});
 };
 
 // ---
@@ -681,7 +1129,7 @@ Mod_join::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node key_value
     errata.note(R"("{}" modifier at {} requires a string argument.)", KEY, key_value.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 };
 
 // ---
@@ -824,7 +1272,7 @@ Mod_concat::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node key_val
     errata.note(R"("{}" modifier at {} requires a string or a list of two strings.)", KEY, key_value.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // ---
@@ -901,7 +1349,7 @@ Mod_as_bool::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node key_va
   if (!(expr.is_null() || expr.result_type().can_satisfy(VALUE_TYPES))) {
     return Errata(S_ERROR, "Value of {} modifier is not of type {}.", KEY, VALUE_TYPES);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // --- //
@@ -986,7 +1434,7 @@ Mod_as_integer::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node key
   if (!(expr.is_null() || expr.result_type().can_satisfy(MaskFor(INTEGER)))) {
     return Errata(S_ERROR, "Value of {} modifier is not of type {}.", KEY, INTEGER);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // --- //
@@ -1066,9 +1514,9 @@ Mod_as_ip_addr::operator()(Context &ctx, Feature &feature)
 }
 
 auto
-Mod_as_ip_addr::load(Config &, YAML::Node, TextView, TextView, YAML::Node) -> Rv<Handle>
+Mod_as_ip_addr::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node) -> Rv<Handle>
 {
-  return Handle(new self_type);
+  return Handle(new (cfg) self_type);
 }
 
 Feature
@@ -1157,7 +1605,7 @@ Mod_As_Duration::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node ke
     errata.note(R"(While parsing "{}" modifier at {}.)", KEY, key_value.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(expr)});
+  return Handle(new (cfg) self_type{std::move(expr)});
 }
 
 // ---
@@ -1233,9 +1681,9 @@ Mod_url_encode::result_type(ActiveType const &) const
 }
 
 Rv<Modifier::Handle>
-Mod_url_encode::load(Config &, YAML::Node, TextView, TextView, YAML::Node)
+Mod_url_encode::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node)
 {
-  return Modifier::Handle(new self_type);
+  return Modifier::Handle(new (cfg) self_type);
 }
 
 Rv<Feature>
@@ -1303,9 +1751,9 @@ Mod_url_decode::result_type(ActiveType const &) const
 }
 
 Rv<Modifier::Handle>
-Mod_url_decode::load(Config &, YAML::Node, TextView, TextView, YAML::Node)
+Mod_url_decode::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node)
 {
-  return Modifier::Handle(new self_type);
+  return Modifier::Handle(new (cfg) self_type);
 }
 
 Rv<Feature>
@@ -1320,12 +1768,167 @@ Mod_url_decode::operator()(Context &ctx, feature_type_for<STRING> feature)
   }
   return NIL_FEATURE;
 }
+
+// ---
+/// base64-encode modifier
+class Mod_base64_encode : public Modifier
+{
+  using self_type  = Mod_base64_encode;
+  using super_type = Modifier;
+
+public:
+  inline static const std::string KEY = "base64-encode";
+
+  /** Check if @a ftype is a valid type to be modified.
+   *
+   * @param ftype Type of feature to modify.
+   * @return @c true if this modifier can modity that feature type, @c false if not.
+   */
+  bool is_valid_for(ActiveType const &ex_type) const override;
+
+  /// Resulting type of feature after modifying.
+  ActiveType result_type(ActiveType const &) const override;
+
+  /** Modify the feature.
+   *
+   * @param ctx Run time context.
+   * @param feature Feature to modify
+   * @return Errors, if any.
+   */
+  Rv<Feature> operator()(Context &ctx, feature_type_for<STRING> feature) override;
+
+  /** Create an instance from YAML config.
+   *
+   * @param cfg Configuration state object.
+   * @param mod_node Node with modifier.
+   * @param key_node Node in @a mod_node that identifies the modifier.
+   * @return A constructed instance or errors.
+   */
+  static Rv<super_type::Handle> load(Config &, YAML::Node, TextView, TextView, YAML::Node);
+
+protected:
+  bool _url_p = false; ///< Use the url alphabet without padding.
+
+  explicit Mod_base64_encode(bool url_p) : _url_p(url_p) {}
+};
+
+bool
+Mod_base64_encode::is_valid_for(ActiveType const &ex_type) const
+{
+  return ex_type.can_satisfy(MaskFor(NIL, STRING));
+}
+
+ActiveType
+Mod_base64_encode::result_type(ActiveType const &) const
+{
+  return {MaskFor({NIL, STRING})};
+}
+
+Rv<Modifier::Handle>
+Mod_base64_encode::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
+{
+  bool url_p = false;
+  if (key_value && !key_value.IsNull()) {
+    TextView alphabet;
+    if (key_value.IsScalar()) {
+      alphabet = key_value.Scalar();
+    }
+    if (0 == strcasecmp(alphabet, "url"_tv)) {
+      url_p = true;
+    } else if (0 != strcasecmp(alphabet, "standard"_tv)) {
+      return Errata(S_ERROR, R"(Value for "{}" at {} in modifier at {} must be "standard" or "url".)", KEY, key_value.Mark(),
+                    node.Mark());
+    }
+  }
+  return Modifier::Handle(new (cfg) self_type(url_p));
+}
+
+Rv<Feature>
+Mod_base64_encode::operator()(Context &ctx, feature_type_for<STRING> feature)
+{
+  // The encoded size is exact, so allocate once directly in the context arena.
+  auto span = ctx.alloc_span<char>(base64_encoded_size(feature.size(), _url_p));
+  base64_encode(span, feature, _url_p);
+  return {FeatureView::Literal(TextView{span.data(), span.size()})};
+}
+
+// ---
+/// base64-decode modifier
+class Mod_base64_decode : public Modifier
+{
+  using self_type  = Mod_base64_decode;
+  using super_type = Modifier;
+
+public:
+  inline static const std::string KEY = "base64-decode";
+
+  /** Check if @a ftype is a valid type to be modified.
+   *
+   * @param ftype Type of feature to modify.
+   * @return @c true if this modifier can modity that feature type, @c false if not.
+   */
+  bool is_valid_for(ActiveType const &ex_type) const override;
+
+  /// Resulting type of feature after modifying.
+  ActiveType result_type(ActiveType const &) const override;
+
+  /** Modify the feature.
+   *
+   * @param ctx Run time context.
+   * @param feature Feature to modify
+   * @return Errors, if any.
+   */
+  Rv<Feature> operator()(Context &ctx, feature_type_for<STRING> feature) override;
+
+  /** Create an instance from YAML config.
+   *
+   * @param cfg Configuration state object.
+   * @param mod_node Node with modifier.
+   * @param key_node Node in @a mod_node that identifies the modifier.
+   * @return A constructed instance or errors.
+   */
+  static Rv<super_type::Handle> load(Config &, YAML::Node, TextView, TextView, YAML::Node);
+};
+
+bool
+Mod_base64_decode::is_valid_for(ActiveType const &ex_type) const
+{
+  return ex_type.can_satisfy(MaskFor(NIL, STRING));
+}
+
+ActiveType
+Mod_base64_decode::result_type(ActiveType const &) const
+{
+  return {MaskFor({NIL, STRING})};
+}
+
+Rv<Modifier::Handle>
+Mod_base64_decode::load(Config &cfg, YAML::Node, TextView, TextView, YAML::Node)
+{
+  return Modifier::Handle(new (cfg) self_type);
+}
+
+Rv<Feature>
+Mod_base64_decode::operator()(Context &ctx, feature_type_for<STRING> feature)
+{
+  auto size = base64_decoded_size(feature);
+  if (size < 0) {
+    return NIL_FEATURE;
+  }
+  auto span = ctx.alloc_span<char>(size);
+  if (base64_decode(span, feature) < 0) {
+    return NIL_FEATURE;
+  }
+  return {FeatureView::Literal(TextView{span.data(), span.size()})};
+}
 // --- //
 
 namespace
 {
 [[maybe_unused]] bool INITIALIZED = []() -> bool {
   Modifier::define(Mod_hash::KEY, &Mod_hash::load);
+  Modifier::define(Mod_digest::KEY, &Mod_digest::load);
+  Modifier::define(Mod_consistent_hash::KEY, &Mod_consistent_hash::load);
   Modifier::define(Mod_else::KEY, &Mod_else::load);
   Modifier::define(Mod_join::KEY, &Mod_join::load);
   Modifier::define(Mod_concat::KEY, &Mod_concat::load);
@@ -1337,6 +1940,8 @@ namespace
   Modifier::define(Mod_rxp_replace::KEY, &Mod_rxp_replace::load);
   Modifier::define(Mod_url_encode::KEY, &Mod_url_encode::load);
   Modifier::define(Mod_url_decode::KEY, &Mod_url_decode::load);
+  Modifier::define(Mod_base64_encode::KEY, &Mod_base64_encode::load);
+  Modifier::define(Mod_base64_decode::KEY, &Mod_base64_decode::load);
   return true;
 }();
 } // namespace
@@ -48,6 +48,14 @@ Rxp::capture_count() const
   auto result    = pcre2_pattern_info(_rxp.get(), PCRE2_INFO_CAPTURECOUNT, &count);
   return result == 0 ? count + 1 : 0; // output doesn't reflect capture group 0, apparently.
 }
+
+size_t
+Rxp::size() const
+{
+  size_t size = 0;
+  auto result = pcre2_pattern_info(_rxp.get(), PCRE2_INFO_SIZE, &size);
+  return result == 0 ? size : 0;
+}
 /* ------------------------------------------------------------------------------------ */
 RxpOp::RxpOp(Rxp && rxp) : _raw(std::move(rxp)) {}
 RxpOp::RxpOp(Expr && expr, Rxp::Options opt) : _raw(DynamicRxp{std::move(expr), opt}) {}
@@ -64,7 +72,7 @@ RxpOp::Cfg_Visitor::operator()(Feature &f)
     rxp_errata.note(R"(While parsing regular expression.)");
     return std::move(rxp_errata);
   }
-  _cfg.require_rxp_group_count(rxp.capture_count());
+  _cfg.require_rxp(rxp);
   return RxpOp(std::move(rxp));
 }
 
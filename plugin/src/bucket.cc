@@ -0,0 +1,227 @@
+/** @file
+   Deterministic bucketing for traffic ramps.
+
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <limits>
+
+#include "txn_box/common.h"
+
+#include <swoc/TextView.h>
+#include <swoc/Errata.h>
+#include <swoc/BufferWriter.h>
+#include <swoc/bwf_base.h>
+#include <swoc/bwf_ip.h>
+
+#include "txn_box/Directive.h"
+#include "txn_box/Extractor.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+
+#include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
+
+using swoc::TextView;
+using swoc::Errata;
+using swoc::Rv;
+using swoc::BufferWriter;
+namespace bwf = swoc::bwf;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+/** Per transaction bucket key state.
+ *
+ * The key is hashed once per transaction and every @c bucket extractor mixes its salt in to that
+ * hash, so any number of ramps cost a single hash of the key.
+ */
+struct BucketState {
+  bool _valid_p  = false; ///< Key hash has been computed.
+  uint64_t _hash = 0;     ///< Hash of the key.
+
+  /// Name of the shared context storage.
+  static constexpr TextView CTX_KEY{"bucket"};
+
+  /// Reserve (if needed) the shared context storage in @a cfg.
+  static ReservedSpan reserve(Config &cfg);
+
+  /// Hash @a feature as the key.
+  static uint64_t hash_of(Context &ctx, Feature const &feature);
+};
+
+ReservedSpan
+BucketState::reserve(Config &cfg)
+{
+  auto span = cfg.obtain_named_object<ReservedSpan>(CTX_KEY);
+  if (span->n == 0) {
+    *span = cfg.reserve_ctx_storage(sizeof(BucketState));
+  }
+  return *span;
+}
+
+uint64_t
+BucketState::hash_of(Context &ctx, Feature const &feature)
+{
+  TextView text;
+  if (auto view = std::get_if<IndexFor(STRING)>(&feature); nullptr != view) {
+    text = *view;
+  } else {
+    text = ctx.render_transient([&](BufferWriter &w) { bwformat(w, bwf::Spec::DEFAULT, feature); });
+  }
+  return Hash64Wy(text);
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Set the key for @c bucket extractors in this transaction.
+ */
+class Do_bucket_key : public Directive
+{
+  using self_type  = Do_bucket_key; ///< Self reference type.
+  using super_type = Directive;     ///< Parent type.
+public:
+  static inline const std::string KEY{"bucket-key"}; ///< Directive name.
+  static const HookMask HOOKS;                       ///< Valid hooks for directive.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  Expr _key;              ///< Key expression.
+  ReservedSpan _ctx_span; ///< Shared bucket state.
+
+  Do_bucket_key(Expr &&key, ReservedSpan span) : _key(std::move(key)), _ctx_span(span) {}
+};
+
+const HookMask Do_bucket_key::HOOKS{
+  MaskFor({Hook::TXN_START, Hook::CREQ, Hook::PRE_REMAP, Hook::REMAP, Hook::POST_REMAP, Hook::PREQ, Hook::URSP, Hook::PRSP})};
+
+Errata
+Do_bucket_key::invoke(Context &ctx)
+{
+  auto &state    = ctx.initialized_storage_for<BucketState>(_ctx_span)[0];
+  state._hash    = BucketState::hash_of(ctx, ctx.extract(_key));
+  state._valid_p = true;
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_bucket_key::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
+                    YAML::Node key_value)
+{
+  auto &&[expr, errata]{cfg.parse_expr(key_value)};
+  if (!errata.is_ok()) {
+    errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+    return std::move(errata);
+  }
+  return Handle(new (cfg) self_type(std::move(expr), BucketState::reserve(cfg)));
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Stable bucket in [0, N) for the transaction key.
+ *
+ * The key is set by @c Do_bucket_key, or is the client address if that has not been invoked. The
+ * optional salt makes the buckets of different ramps independent of each other.
+ */
+class Ex_bucket : public Extractor
+{
+  using self_type  = Ex_bucket; ///< Self reference type.
+  using super_type = Extractor; ///< Parent type.
+public:
+  static constexpr TextView NAME{"bucket"}; ///< Extractor name.
+
+  /// Default number of buckets.
+  static constexpr feature_type_for<INTEGER> DEFAULT_N = 100;
+
+  /// Verify the arguments are a bucket count and salt.
+  Rv<ActiveType> validate(Config &cfg, Spec &spec, TextView const &arg) override;
+
+  /// Extract the feature from the @a ctx.
+  Feature extract(Context &ctx, Extractor::Spec const &spec) override;
+
+protected:
+  /// Configuration data.
+  struct Info {
+    ReservedSpan _span; ///< Shared bucket state.
+    uint64_t _salt = 0; ///< Hash of the salt.
+    uint64_t _n    = 0; ///< Number of buckets.
+  };
+
+  /// Finalizer from SplitMix64, to spread the salted hash across all bits.
+  static uint64_t
+  mix(uint64_t x)
+  {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+};
+
+Rv<ActiveType>
+Ex_bucket::validate(Config &cfg, Extractor::Spec &spec, TextView const &arg)
+{
+  auto info       = cfg.alloc_span<Info>(1);
+  spec._data.span = info;
+  info[0]         = Info{};
+  info[0]._span   = BucketState::reserve(cfg);
+  info[0]._n      = DEFAULT_N;
+
+  TextView salt{arg};
+  auto n_arg = salt.take_prefix_at(',');
+  n_arg.trim_if(&isspace);
+  salt.trim_if(&isspace);
+  if (n_arg) {
+    TextView parsed;
+    auto n = swoc::svtou(n_arg, &parsed);
+    if (parsed.size() != n_arg.size() || n < 2 || n > std::numeric_limits<uint32_t>::max()) {
+      return Errata(S_ERROR, R"(Parameter "{}" for "{}" is not an integer of at least 2 as required.)", n_arg, NAME);
+    }
+    info[0]._n = n;
+  }
+  if (salt) {
+    info[0]._salt = Hash64Wy(salt);
+  }
+
+  return ActiveType{INTEGER};
+}
+
+Feature
+Ex_bucket::extract(Context &ctx, Extractor::Spec const &spec)
+{
+  auto const &info = spec._data.span.rebind<Info>()[0];
+  auto &state      = ctx.initialized_storage_for<BucketState>(info._span)[0];
+  if (!state._valid_p) {
+    Feature key{NIL_FEATURE};
+    if (auto addr = ctx.inbound_ssn().addr_remote(); addr) {
+      key = swoc::IPAddr{addr};
+    }
+    state._hash    = BucketState::hash_of(ctx, key);
+    state._valid_p = true;
+  }
+  return feature_type_for<INTEGER>(mix(state._hash ^ info._salt) % info._n);
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+namespace
+{
+Ex_bucket bucket;
+
+[[maybe_unused]] bool INITIALIZED = []() -> bool {
+  Config::define<Do_bucket_key>();
+  Extractor::define(Ex_bucket::NAME, &bucket);
+  return true;
+}();
+} // namespace
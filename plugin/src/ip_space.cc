@@ -614,7 +614,7 @@ Rv<Directive::Handle>
 Do_ip_space_define::load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &,
                          swoc::TextView const &, YAML::Node key_value)
 {
-  auto self = new self_type();
+  auto self = new (cfg) self_type();
   Handle handle(self);
   self->_line_no = drtv_node.Mark().line;
 
@@ -872,7 +872,7 @@ Mod_ip_space::load(Config &cfg, YAML::Node node, TextView, TextView arg, YAML::N
     errata.note(R"(While parsing "{}" modifier at {}.)", KEY, key_value.Mark());
     return std::move(errata);
   }
-  return Handle(new self_type{std::move(expr), cfg.localize(arg), info._drtv});
+  return Handle(new (cfg) self_type{std::move(expr), cfg.localize(arg), info._drtv});
 }
 
 Rv<Feature>
@@ -0,0 +1,504 @@
+/** @file
+   Structured logging directive.
+
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "txn_box/common.h"
+
+#include <swoc/TextView.h>
+#include <swoc/Errata.h>
+#include <swoc/BufferWriter.h>
+#include <swoc/bwf_base.h>
+
+#include "txn_box/Directive.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+
+#include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
+
+using swoc::TextView;
+using swoc::Errata;
+using swoc::Rv;
+using swoc::BufferWriter;
+namespace bwf = swoc::bwf;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+/** Buffered output to a TS text log.
+ *
+ * Each thread that writes to the stream gets its own single producer, single consumer ring
+ * buffer, so writing a record is a copy and an atomic store with no locks. A periodic task drains
+ * the rings and writes the records to the TS text log, so the log API is never called on a worker
+ * thread. A ring that is full drops the record and counts it rather than blocking the thread.
+ *
+ * Streams are never destroyed, so the TS log objects and the per thread rings persist across
+ * configuration reloads.
+ */
+class LogStream
+{
+  using self_type = LogStream; ///< Self reference type.
+public:
+  static constexpr size_t RING_SIZE = 1 << 16; ///< Bytes per thread ring, must be a power of 2.
+  static constexpr std::chrono::milliseconds FLUSH_PERIOD{250}; ///< Time between flushes.
+
+  /** Find or create the stream for a log.
+   *
+   * @param name Name of the TS text log.
+   * @return The stream, or errors if the log could not be created.
+   */
+  static Rv<self_type *> obtain(TextView name);
+
+  /** Write a record.
+   *
+   * @param record Record text, without a trailing newline.
+   * @return @c true if the record was buffered, @c false if it was dropped.
+   */
+  bool write(TextView record);
+
+  /// Count a record dropped by a rate limit.
+  void
+  limited()
+  {
+    _limited.fetch_add(1, std::memory_order_relaxed);
+  }
+
+protected:
+  /// Single producer, single consumer byte ring. Records are stored as a length and the text.
+  struct Ring {
+    std::unique_ptr<char[]> _data{new char[RING_SIZE]};
+    alignas(64) std::atomic<size_t> _head{0}; ///< Write position, updated by the owning thread.
+    alignas(64) std::atomic<size_t> _tail{0}; ///< Read position, updated by the flush task.
+
+    /// Add @a record, @return @c false if there is not enough space.
+    bool push(TextView record);
+
+    /// Pass each record to @a f and remove it.
+    template <typename F> void drain(std::string &tmp, F &&f);
+
+  protected:
+    void copy_in(size_t pos, void const *src, size_t n);
+    void copy_out(size_t pos, void *dst, size_t n) const;
+  };
+
+  std::string _name;                       ///< Log name.
+  TSTextLogObject _log = nullptr;          ///< TS log.
+  std::mutex _rings_mutex;                 ///< Protects @a _rings.
+  std::vector<std::unique_ptr<Ring>> _rings; ///< Per thread rings.
+  std::vector<Ring *> _drain_rings;        ///< Rings to drain, used only by @c flush.
+  std::atomic<uint64_t> _overflow{0};      ///< Records dropped because a ring was full.
+  std::atomic<uint64_t> _limited{0};       ///< Records dropped by a rate limit.
+
+  explicit LogStream(TextView name) : _name(name) {}
+
+  /// @return The ring for the calling thread.
+  Ring &ring();
+
+  /// Write buffered records to the log.
+  void flush();
+
+  /// Flush all streams.
+  static void flush_all();
+
+  /// All streams, by name.
+  static inline std::mutex _streams_mutex;
+  static inline std::map<std::string, std::unique_ptr<self_type>, std::less<>> _streams;
+  static inline ts::TaskHandle _flush_task;
+};
+
+void
+LogStream::Ring::copy_in(size_t pos, void const *src, size_t n)
+{
+  auto offset = pos & (RING_SIZE - 1);
+  auto k      = std::min(n, RING_SIZE - offset);
+  memcpy(_data.get() + offset, src, k);
+  memcpy(_data.get(), static_cast<char const *>(src) + k, n - k);
+}
+
+void
+LogStream::Ring::copy_out(size_t pos, void *dst, size_t n) const
+{
+  auto offset = pos & (RING_SIZE - 1);
+  auto k      = std::min(n, RING_SIZE - offset);
+  memcpy(dst, _data.get() + offset, k);
+  memcpy(static_cast<char *>(dst) + k, _data.get(), n - k);
+}
+
+bool
+LogStream::Ring::push(TextView record)
+{
+  uint32_t size = record.size();
+  auto n        = sizeof(size) + size;
+  auto head     = _head.load(std::memory_order_relaxed);
+  if (RING_SIZE - (head - _tail.load(std::memory_order_acquire)) < n) {
+    return false;
+  }
+  this->copy_in(head, &size, sizeof(size));
+  this->copy_in(head + sizeof(size), record.data(), size);
+  _head.store(head + n, std::memory_order_release);
+  return true;
+}
+
+template <typename F>
+void
+LogStream::Ring::drain(std::string &tmp, F &&f)
+{
+  auto tail = _tail.load(std::memory_order_relaxed);
+  auto head = _head.load(std::memory_order_acquire);
+  while (tail < head) {
+    uint32_t size;
+    this->copy_out(tail, &size, sizeof(size));
+    tmp.resize(size);
+    this->copy_out(tail + sizeof(size), tmp.data(), size);
+    tail += sizeof(size) + size;
+    _tail.store(tail, std::memory_order_release); // release the space as soon as possible.
+    f(TextView{tmp});
+  }
+}
+
+auto
+LogStream::obtain(TextView name) -> Rv<self_type *>
+{
+  std::lock_guard lock(_streams_mutex);
+  if (auto spot = _streams.find(name); spot != _streams.end()) {
+    return spot->second.get();
+  }
+
+  std::unique_ptr<self_type> stream{new self_type(name)};
+  if (TS_SUCCESS != TSTextLogObjectCreate(stream->_name.c_str(), TS_LOG_MODE_ADD_TIMESTAMP, &stream->_log)) {
+    return Errata(S_ERROR, R"(Unable to create log "{}".)", name);
+  }
+  if (_streams.empty()) {
+    _flush_task = ts::PerformAsTaskEvery(&self_type::flush_all, FLUSH_PERIOD);
+  }
+  auto zret = stream.get();
+  _streams.emplace(stream->_name, std::move(stream));
+  return zret;
+}
+
+auto
+LogStream::ring() -> Ring &
+{
+  // Streams are never destroyed, so these pointers are always valid.
+  thread_local std::unordered_map<self_type *, Ring *> rings;
+  if (auto spot = rings.find(this); spot != rings.end()) {
+    return *spot->second;
+  }
+  std::lock_guard lock(_rings_mutex);
+  auto r = _rings.emplace_back(new Ring).get();
+  rings[this] = r;
+  return *r;
+}
+
+bool
+LogStream::write(TextView record)
+{
+  if (record.size() + sizeof(uint32_t) > RING_SIZE || !this->ring().push(record)) {
+    _overflow.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void
+LogStream::flush()
+{
+  std::string tmp;
+  // Rings are never removed, so it is safe to drain them after the lock is released. This keeps
+  // the lock from blocking a thread that is creating its ring while the log is written.
+  {
+    std::lock_guard lock(_rings_mutex);
+    _drain_rings.clear();
+    for (auto &r : _rings) {
+      _drain_rings.push_back(r.get());
+    }
+  }
+  for (auto r : _drain_rings) {
+    r->drain(tmp, [&](TextView record) { TSTextLogObjectWrite(_log, "%.*s", static_cast<int>(record.size()), record.data()); });
+  }
+  auto overflow = _overflow.exchange(0, std::memory_order_relaxed);
+  auto limited  = _limited.exchange(0, std::memory_order_relaxed);
+  if (overflow || limited) {
+    TSTextLogObjectWrite(_log, "%s: dropped %" PRIu64 " records because the buffer was full, %" PRIu64 " by rate limit.",
+                         Config::PLUGIN_TAG.data(), overflow, limited);
+  }
+}
+
+void
+LogStream::flush_all()
+{
+  std::lock_guard lock(_streams_mutex);
+  for (auto &[name, stream] : _streams) {
+    stream->flush();
+  }
+}
+
+/* ------------------------------------------------------------------------------------ */
+/// Write a structured record to a log.
+class Do_log : public Directive
+{
+  using self_type  = Do_log;    ///< Self reference type.
+  using super_type = Directive; ///< Parent type.
+public:
+  static inline const std::string KEY{"log"}; ///< Directive name.
+  static const HookMask HOOKS;                ///< Valid hooks for directive.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML configuration.
+   *
+   * @param cfg Configuration data.
+   * @param drtv_node Node containing the directive.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  /// Record format.
+  enum Format { KV, JSON };
+
+  /// A field in the record.
+  struct Field {
+    TextView _name; ///< Field name.
+    Expr _expr;     ///< Field value.
+  };
+
+  LogStream *_stream = nullptr; ///< Output.
+  Format _format     = KV;      ///< Record format.
+  std::vector<Field> _fields;   ///< Record fields.
+  unsigned _rate = 0;           ///< Maximum records per second, 0 for no limit.
+  /// Rate limit state - packed second (upper 32 bits) and record count in that second.
+  std::atomic<uint64_t> _window{0};
+
+  static inline const std::string NAME_TAG{"name"};
+  static inline const std::string FORMAT_TAG{"format"};
+  static inline const std::string FIELDS_TAG{"fields"};
+  static inline const std::string RATE_TAG{"rate"};
+
+  /// Format names.
+  static inline const swoc::Lexicon<Format> FormatNames{{{KV, "kv"}, {JSON, "json"}}, KV};
+
+  Do_log() = default;
+
+  /// @return @c true if a record is permitted by the rate limit.
+  bool admit();
+
+  /// Write @a text as a key / value value, quoted if needed.
+  static void kv_value(BufferWriter &w, TextView text);
+  /// Write @a value in the record format.
+  void write_value(BufferWriter &w, Feature const &value) const;
+};
+
+const HookMask Do_log::HOOKS{MaskFor({Hook::POST_LOAD, Hook::TXN_START, Hook::CREQ, Hook::PREQ, Hook::URSP, Hook::PRSP,
+                                      Hook::PRE_REMAP, Hook::POST_REMAP, Hook::REMAP, Hook::TXN_CLOSE})};
+
+bool
+Do_log::admit()
+{
+  if (_rate == 0) {
+    return true;
+  }
+  uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  auto state   = _window.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    if ((state >> 32) != (now & 0xFFFFFFFF)) {
+      next = (now << 32) | 1; // new window.
+    } else if ((state & 0xFFFFFFFF) < _rate) {
+      next = state + 1;
+    } else {
+      return false;
+    }
+  } while (!_window.compare_exchange_weak(state, next, std::memory_order_relaxed));
+  return true;
+}
+
+void
+Do_log::kv_value(BufferWriter &w, TextView text)
+{
+  bool quote_p = text.empty() || text.end() != std::find_if(text.begin(), text.end(), [](char c) {
+                   return c == ' ' || c == '"' || c == '=' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+                 });
+  if (!quote_p) {
+    w.write(text);
+    return;
+  }
+  w.write('"');
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      w.write('\\').write(c);
+    } else if (c == '\n') {
+      w.write("\\n"_tv);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      w.write(' ');
+    } else {
+      w.write(c);
+    }
+  }
+  w.write('"');
+}
+
+void
+Do_log::write_value(BufferWriter &w, Feature const &value) const
+{
+  if (_format == JSON) {
+    switch (value.value_type()) {
+    case NIL:
+      w.write("null"_tv);
+      return;
+    case INTEGER:
+    case FLOAT:
+    case BOOLEAN:
+      bwformat(w, bwf::Spec::DEFAULT, value);
+      return;
+    default:
+      break;
+    }
+  }
+
+  swoc::LocalBufferWriter<256> lw;
+  TextView text;
+  if (auto view = std::get_if<IndexFor(STRING)>(&value); view) {
+    text = *view;
+  } else {
+    bwformat(lw, bwf::Spec::DEFAULT, value);
+    text = lw.view();
+  }
+  if (_format == JSON) {
+    json_string(w, text);
+  } else {
+    kv_value(w, text);
+  }
+}
+
+Errata
+Do_log::invoke(Context &ctx)
+{
+  // Check the limit first so a dropped record costs no extraction.
+  if (!this->admit()) {
+    _stream->limited();
+    return {};
+  }
+
+  // Extract first, committing so that later extractions don't overwrite earlier ones.
+  auto values = ctx.alloc_span<Feature>(_fields.size());
+  for (unsigned idx = 0; idx < _fields.size(); ++idx) {
+    values[idx] = ctx.extract(_fields[idx]._expr);
+    ctx.commit(values[idx]);
+  }
+
+  auto record = ctx.render_transient([&](BufferWriter &w) {
+    if (_format == JSON) {
+      w.write('{');
+    }
+    for (unsigned idx = 0; idx < _fields.size(); ++idx) {
+      if (idx > 0) {
+        w.write(_format == JSON ? ',' : ' ');
+      }
+      if (_format == JSON) {
+        json_string(w, _fields[idx]._name);
+        w.write(':');
+      } else {
+        w.write(_fields[idx]._name).write('=');
+      }
+      this->write_value(w, values[idx]);
+    }
+    if (_format == JSON) {
+      w.write('}');
+    }
+  });
+  _stream->write(record);
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_log::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
+             YAML::Node key_value)
+{
+  if (!key_value.IsMap()) {
+    return Errata(S_ERROR, R"(Value for "{}" directive at {} must be a map.)", KEY, drtv_node.Mark());
+  }
+
+  auto self = new (cfg) self_type;
+  Handle handle(self);
+
+  auto name_node = key_value[NAME_TAG];
+  if (!name_node || !name_node.IsScalar() || name_node.Scalar().empty()) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key with the name of the log.)", KEY, drtv_node.Mark(), NAME_TAG);
+  }
+  auto &&[stream, stream_errata]{LogStream::obtain(name_node.Scalar())};
+  if (!stream_errata.is_ok()) {
+    stream_errata.note(R"(While loading "{}" directive at {}.)", KEY, drtv_node.Mark());
+    return std::move(stream_errata);
+  }
+  self->_stream = stream;
+
+  if (auto format_node = key_value[FORMAT_TAG]; format_node) {
+    auto format = FormatNames[TextView{format_node.Scalar()}];
+    if (format_node.Scalar() != FormatNames[format]) {
+      return Errata(S_ERROR, R"("{}" value at {} must be "{}" or "{}".)", FORMAT_TAG, format_node.Mark(), FormatNames[KV],
+                    FormatNames[JSON]);
+    }
+    self->_format = format;
+  }
+
+  auto fields_node = key_value[FIELDS_TAG];
+  if (!fields_node || !fields_node.IsMap() || fields_node.size() == 0) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key with a map of field names to values.)", KEY,
+                  drtv_node.Mark(), FIELDS_TAG);
+  }
+  self->_fields.reserve(fields_node.size());
+  for (auto const &[field_key, field_value] : fields_node) {
+    auto &&[expr, errata]{cfg.parse_expr(field_value)};
+    if (!errata.is_ok()) {
+      errata.note(R"(While parsing field "{}" at {} in "{}" directive at {}.)", field_key.Scalar(), field_value.Mark(), KEY,
+                  drtv_node.Mark());
+      return std::move(errata);
+    }
+    self->_fields.emplace_back(Field{cfg.localize(TextView{field_key.Scalar()}), std::move(expr)});
+  }
+
+  if (auto rate_node = key_value[RATE_TAG]; rate_node) {
+    auto &&[expr, errata]{cfg.parse_expr(rate_node)};
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+    if (!expr.is_literal()) {
+      return Errata(S_ERROR, R"("{}" value at {} must be a literal integer.)", RATE_TAG, rate_node.Mark());
+    }
+    auto &&[n, n_errata]{std::get<Expr::LITERAL>(expr._raw).as_integer(-1)};
+    if (!n_errata.is_ok() || n <= 0 || n > std::numeric_limits<uint32_t>::max()) {
+      return Errata(S_ERROR, R"("{}" value at {} must be a positive integer.)", RATE_TAG, rate_node.Mark());
+    }
+    self->_rate = n;
+  }
+
+  return handle;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+namespace
+{
+[[maybe_unused]] bool INITIALIZED = []() -> bool {
+  Config::define<Do_log>();
+  return true;
+}();
+} // namespace
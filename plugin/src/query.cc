@@ -406,7 +406,7 @@ Rv<Feature> Mod_query_sort::operator()(Context &ctx, feature_type_for<STRING> qs
 }
 
 Rv<Modifier::Handle>
-Mod_query_sort::load(Config &, YAML::Node, TextView, TextView arg, YAML::Node)
+Mod_query_sort::load(Config &cfg, YAML::Node, TextView, TextView arg, YAML::Node)
 {
   bool case_p = true;
   bool rev_p = false;
@@ -420,7 +420,7 @@ Mod_query_sort::load(Config &, YAML::Node, TextView, TextView arg, YAML::Node)
       return Errata(S_ERROR,R"(Invalid argument "{}" in modifier "{}")", token, KEY);
     }
   }
-  return Handle{new self_type(case_p, rev_p)};
+  return Handle{new (cfg) self_type(case_p, rev_p)};
 }
 
 // ---
@@ -687,7 +687,7 @@ Mod_query_filter::Case::pre_load(Config &cfg, YAML::Node cmp_node) {
 
 Rv<Modifier::Handle> Mod_query_filter::load(Config &cfg, YAML::Node node, TextView, TextView, YAML::Node key_value)
 {
-  auto self = new self_type;
+  auto self = new (cfg) self_type;
   Handle handle(self);
   let local_ex_scope{cfg._local_extractors, &_ex_table};
 
@@ -836,7 +836,7 @@ Do_ua_req_query::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node,
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 /** Set the query for the proxy request.
@@ -887,7 +887,7 @@ Do_proxy_req_query::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_nod
   if (!expr.result_type().can_satisfy(STRING)) {
     return Errata(S_ERROR,R"(Value for "{}" directive at {} must be a string.)", KEY, drtv_node.Mark());
   }
-  return Handle(new self_type(std::move(expr)));
+  return Handle(new (cfg) self_type(std::move(expr)));
 }
 /* ------------------------------------------------------------------------------------ */
 class QueryValueDirective : public Directive
@@ -1005,7 +1005,7 @@ Do_ua_req_query_value::load(Config &cfg, CfgStaticData const *, YAML::Node, swoc
                             YAML::Node key_value)
 {
   return super_type::load(
-    cfg, [](TextView const &name, Expr &&fmt) -> Handle { return Handle(new self_type(name, std::move(fmt))); }, KEY, arg,
+    cfg, [&cfg](TextView const &name, Expr &&fmt) -> Handle { return Handle(new (cfg) self_type(name, std::move(fmt))); }, KEY, arg,
     key_value);
 }
 
@@ -1047,7 +1047,7 @@ Do_proxy_req_query_value::load(Config &cfg, CfgStaticData const *, YAML::Node, s
                                YAML::Node key_value)
 {
   return super_type::load(
-    cfg, [](TextView const &name, Expr &&fmt) -> Handle { return Handle(new self_type(name, std::move(fmt))); }, KEY, arg,
+    cfg, [&cfg](TextView const &name, Expr &&fmt) -> Handle { return Handle(new (cfg) self_type(name, std::move(fmt))); }, KEY, arg,
     key_value);
 }
 /* ------------------------------------------------------------------------------------ */
@@ -0,0 +1,638 @@
+/** @file
+   Rate and concurrency limiting directives and comparison.
+
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+
+#include "txn_box/common.h"
+
+#include <swoc/TextView.h>
+#include <swoc/Errata.h>
+#include <swoc/BufferWriter.h>
+#include <swoc/bwf_base.h>
+
+#include "txn_box/Directive.h"
+#include "txn_box/Comparison.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+#include "txn_box/Stat.h"
+
+#include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
+
+using swoc::TextView;
+using swoc::Errata;
+using swoc::Rv;
+using swoc::BufferWriter;
+namespace bwf = swoc::bwf;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+/** Token bucket rate limiter.
+ *
+ * This is a fixed size table of token buckets, indexed by a hash of the key feature. The table is
+ * divided in to shards of @c SHARD_SIZE slots, the shard is selected by the key hash and the slots
+ * in the shard are searched linearly. If the key is not in the shard an empty slot is claimed, or
+ * if there are none, a slot is evicted using the clock algorithm. All access is done with atomics
+ * and no locks are used.
+ *
+ * The bucket is tracked as a generic cell rate algorithm schedule, so the state is a single 64 bit
+ * value that is updated with a single compare and swap. This is the theoretical arrival time - the
+ * time, in nanoseconds relative to the creation of the limiter, at which the bucket will be full.
+ * Each token moves it forward by the token interval (@a period / @a rate) and a token is available
+ * if doing that does not put it more than @a burst intervals past the current time. Unlike a
+ * periodic refill, no fraction of a token is lost regardless of how often the bucket is checked.
+ *
+ * @note This is approximate under contention - a key can briefly use the bucket state of a key
+ * that was just evicted from the same slot. Because keys are identified by hash, colliding keys
+ * share a bucket. Neither is a problem for the intended use.
+ */
+class RateLimiter
+{
+  using self_type = RateLimiter; ///< Self reference type.
+public:
+  using Clock = std::chrono::steady_clock;
+  using Handle = std::unique_ptr<self_type>;
+
+  using Nanoseconds = std::chrono::nanoseconds;
+
+  static constexpr unsigned SHARD_SIZE = 16;   ///< Number of slots per shard.
+  static constexpr size_t DEFAULT_SIZE = 4096; ///< Default number of buckets.
+  /// Smallest token interval, which bounds the rounding error of the interval to 0.1%.
+  static constexpr Nanoseconds MIN_INTERVAL{std::chrono::microseconds(1)};
+  /// Largest span of the schedule, to keep the time arithmetic well clear of overflow.
+  static constexpr Nanoseconds MAX_SPAN{std::chrono::hours(24 * 365)};
+
+  /** Construct a limiter.
+   *
+   * @param interval Time to add one token to a bucket.
+   * @param burst Maximum number of tokens in a bucket.
+   * @param size Minimum number of buckets.
+   */
+  RateLimiter(Nanoseconds interval, unsigned burst, size_t size);
+
+  /** Attempt to consume a token for a key.
+   *
+   * @param key Key hash.
+   * @return @c true if a token was available, @c false if the key is over the limit.
+   *
+   * A rejection updates the rejection statistic, if set.
+   */
+  bool consume(uint64_t key);
+
+  /** Compute the key hash of a feature.
+   *
+   * @param ctx Transaction context.
+   * @param feature Key feature.
+   * @return Hash of @a feature.
+   *
+   * Non-string features are rendered to the transient buffer and the text hashed.
+   */
+  static uint64_t hash_of(Context &ctx, Feature const &feature);
+
+  /** Load a limiter from configuration.
+   *
+   * @param cfg Configuration instance.
+   * @param node Node with the limiter keys.
+   * @return A limiter, or errors.
+   */
+  static Rv<Handle> load(Config &cfg, YAML::Node const &node);
+
+  /** Load a literal integer value.
+   *
+   * @param cfg Configuration instance.
+   * @param node Node with the limiter keys.
+   * @param tag Key name.
+   * @param value [out] Loaded value.
+   * @return Errors, if any.
+   *
+   * @a value is unchanged if the key is not present.
+   */
+  static Errata load_integer(Config &cfg, YAML::Node const &node, std::string const &tag, feature_type_for<INTEGER> &value);
+
+  /// YAML key names.
+  ///@{
+  static inline const std::string RATE_TAG{"rate"};
+  static inline const std::string DURATION_TAG{"duration"};
+  static inline const std::string BURST_TAG{"burst"};
+  static inline const std::string SIZE_TAG{"size"};
+  static inline const std::string STAT_TAG{"stat"};
+  ///@}
+
+protected:
+  /// A token bucket.
+  struct Slot {
+    std::atomic<uint64_t> _key{0};   ///< Key hash, zero for an empty slot.
+    std::atomic<uint64_t> _state{0}; ///< Theoretical arrival time.
+    std::atomic<bool> _ref{false};   ///< Reference bit for clock eviction.
+  };
+
+  /// A group of slots searched together.
+  struct alignas(64) Shard {
+    std::array<Slot, SHARD_SIZE> _slots;
+    std::atomic<unsigned> _hand{0}; ///< Clock hand for eviction.
+  };
+
+  uint64_t _interval; ///< Nanoseconds per token.
+  uint64_t _tolerance; ///< Nanoseconds a bucket can be ahead of the current time, for bursts.
+  size_t _shard_mask; ///< Mask for selecting a shard from a hash.
+  std::unique_ptr<Shard[]> _shards; ///< Bucket storage.
+  Clock::time_point _epoch = Clock::now(); ///< Base time for bucket time stamps.
+  Stat _rejected; ///< Rejection statistic.
+
+  /// Find or claim the slot for @a key.
+  Slot &slot_for(uint64_t key);
+
+  /// Current time in the bucket state time base.
+  uint64_t now() const;
+
+  /// Bucket state for a full bucket at time @a t.
+  uint64_t
+  full(uint64_t t) const
+  {
+    return t;
+  }
+};
+
+RateLimiter::RateLimiter(Nanoseconds interval, unsigned burst, size_t size)
+  : _interval(interval.count()), _tolerance(uint64_t(interval.count()) * (burst - 1))
+{
+  // Round the number of shards up to a power of 2 so a mask can be used.
+  size_t n = 1;
+  while (n * SHARD_SIZE < size) {
+    n <<= 1;
+  }
+  _shard_mask = n - 1;
+  _shards.reset(new Shard[n]);
+}
+
+uint64_t
+RateLimiter::now() const
+{
+  return std::chrono::duration_cast<Nanoseconds>(Clock::now() - _epoch).count();
+}
+
+auto
+RateLimiter::slot_for(uint64_t key) -> Slot &
+{
+  auto &shard = _shards[(key >> 32) & _shard_mask];
+  auto t      = this->now();
+
+  // Already present?
+  for (auto &slot : shard._slots) {
+    if (slot._key.load(std::memory_order_relaxed) == key) {
+      slot._ref.store(true, std::memory_order_relaxed);
+      return slot;
+    }
+  }
+
+  // Not found - claim an empty slot if there is one.
+  for (auto &slot : shard._slots) {
+    uint64_t empty = 0;
+    if (slot._key.load(std::memory_order_relaxed) == 0 && slot._key.compare_exchange_strong(empty, key)) {
+      slot._state.store(this->full(t), std::memory_order_relaxed);
+      slot._ref.store(true, std::memory_order_relaxed);
+      return slot;
+    }
+  }
+
+  // No empty slots - evict. Two passes clears every reference bit so a victim is found unless
+  // other threads keep setting them, in which case just take whatever the hand is on.
+  unsigned idx = 0;
+  for (unsigned n = 0; n < SHARD_SIZE * 2; ++n) {
+    idx        = shard._hand.fetch_add(1, std::memory_order_relaxed) % SHARD_SIZE;
+    auto &slot = shard._slots[idx];
+    if (slot._ref.exchange(false, std::memory_order_relaxed)) {
+      continue; // recently used, give it another go around.
+    }
+    auto victim = slot._key.load(std::memory_order_relaxed);
+    if (slot._key.compare_exchange_strong(victim, key)) {
+      slot._state.store(this->full(t), std::memory_order_relaxed);
+      slot._ref.store(true, std::memory_order_relaxed);
+      return slot;
+    }
+  }
+  auto &slot = shard._slots[idx];
+  slot._key.store(key, std::memory_order_relaxed);
+  slot._state.store(this->full(t), std::memory_order_relaxed);
+  return slot;
+}
+
+bool
+RateLimiter::consume(uint64_t key)
+{
+  if (key == 0) { // zero marks an empty slot, remap it.
+    key = 1;
+  }
+  auto &slot   = this->slot_for(key);
+  auto t       = this->now();
+  auto tat     = slot._state.load(std::memory_order_relaxed);
+  uint64_t upd = 0;
+  do {
+    // A bucket that is behind the current time is full, tokens don't accumulate past that.
+    auto base = std::max(tat, t);
+    if (base - t > _tolerance) {
+      if (_rejected.is_set()) {
+        _rejected.update(1);
+      }
+      return false;
+    }
+    upd = base + _interval;
+  } while (!slot._state.compare_exchange_weak(tat, upd, std::memory_order_relaxed));
+  return true;
+}
+
+uint64_t
+RateLimiter::hash_of(Context &ctx, Feature const &feature)
+{
+  TextView text;
+  if (auto view = std::get_if<IndexFor(STRING)>(&feature); nullptr != view) {
+    text = *view;
+  } else {
+    text = ctx.render_transient([&](BufferWriter &w) { bwformat(w, bwf::Spec::DEFAULT, feature); });
+  }
+  return Hash64FNV1a(text);
+}
+
+Errata
+RateLimiter::load_integer(Config &cfg, YAML::Node const &node, std::string const &tag, feature_type_for<INTEGER> &value)
+{
+  if (auto value_node = node[tag]; value_node) {
+    auto &&[expr, errata]{cfg.parse_expr(value_node)};
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+    if (!expr.is_literal()) {
+      return Errata(S_ERROR, R"("{}" value at {} must be a literal integer.)", tag, value_node.Mark());
+    }
+    auto &&[n, n_errata]{std::get<Expr::LITERAL>(expr._raw).as_integer(-1)};
+    if (!n_errata.is_ok() || n <= 0) {
+      return Errata(S_ERROR, R"("{}" value at {} must be a positive integer.)", tag, value_node.Mark());
+    }
+    value = n;
+  }
+  return {};
+}
+
+auto
+RateLimiter::load(Config &cfg, YAML::Node const &node) -> Rv<Handle>
+{
+  if (!node.IsMap()) {
+    return Errata(S_ERROR, R"(Rate limit at {} must be a map.)", node.Mark());
+  }
+
+  feature_type_for<INTEGER> rate = 0;
+  if (!node[RATE_TAG]) {
+    return Errata(S_ERROR, R"(Rate limit at {} must have a "{}" key.)", node.Mark(), RATE_TAG);
+  }
+  if (auto errata = load_integer(cfg, node, RATE_TAG, rate); !errata.is_ok()) {
+    return std::move(errata);
+  }
+
+  feature_type_for<INTEGER> burst = rate;
+  if (auto errata = load_integer(cfg, node, BURST_TAG, burst); !errata.is_ok()) {
+    return std::move(errata);
+  }
+
+  feature_type_for<INTEGER> size = DEFAULT_SIZE;
+  if (auto errata = load_integer(cfg, node, SIZE_TAG, size); !errata.is_ok()) {
+    return std::move(errata);
+  }
+
+  Nanoseconds period{std::chrono::seconds(1)};
+  if (auto dur_node = node[DURATION_TAG]; dur_node) {
+    auto &&[dur_expr, dur_errata]{cfg.parse_expr(dur_node)};
+    if (!dur_errata.is_ok()) {
+      return std::move(dur_errata);
+    }
+    if (!dur_expr.is_literal()) {
+      return Errata(S_ERROR, R"("{}" value at {} must be a literal duration.)", DURATION_TAG, dur_node.Mark());
+    }
+    auto &&[dur_value, dur_value_errata]{std::get<Expr::LITERAL>(dur_expr._raw).as_duration()};
+    if (!dur_value_errata.is_ok() || dur_value.count() <= 0) {
+      return Errata(S_ERROR, R"("{}" value at {} is not a valid duration.)", DURATION_TAG, dur_node.Mark());
+    }
+    if (dur_value > MAX_SPAN) {
+      return Errata(S_ERROR, R"("{}" value at {} must be no more than a year.)", DURATION_TAG, dur_node.Mark());
+    }
+    period = std::chrono::duration_cast<Nanoseconds>(dur_value);
+  }
+
+  // The schedule is exact except for rounding the interval to a whole nanosecond.
+  Nanoseconds interval{period.count() / rate};
+  if (interval < MIN_INTERVAL) {
+    return Errata(S_ERROR, R"("{}" value at {} is too large, the limit is {} per "{}".)", RATE_TAG, node[RATE_TAG].Mark(),
+                  period / MIN_INTERVAL, DURATION_TAG);
+  }
+  // Check against the span to prevent overflow. Report against the rate if the burst is the default.
+  if (uint64_t(burst) > uint64_t(MAX_SPAN / interval)) {
+    auto const &tag = node[BURST_TAG] ? BURST_TAG : RATE_TAG;
+    return Errata(S_ERROR, R"("{}" value at {} is too large, a burst can't take more than a year to refill.)", tag,
+                  node[tag].Mark());
+  }
+
+  Handle limiter{new self_type(interval, burst, size)};
+
+  if (auto stat_node = node[STAT_TAG]; stat_node) {
+    if (!stat_node.IsScalar()) {
+      return Errata(S_ERROR, R"("{}" value at {} must be the name of a statistic.)", STAT_TAG, stat_node.Mark());
+    }
+    limiter->_rejected.assign(cfg, stat_node.Scalar());
+  }
+
+  return limiter;
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Rate limit a key.
+ * If the key is over the limit, the @c reject directives are invoked.
+ */
+class Do_rate_limit : public Directive
+{
+  using self_type  = Do_rate_limit; ///< Self reference type.
+  using super_type = Directive;     ///< Parent type.
+public:
+  static inline const std::string KEY{"rate-limit"}; ///< Directive name.
+  static const HookMask HOOKS;                       ///< Valid hooks for directive.
+
+  static inline const std::string KEY_TAG{"key"};       ///< Key for the rate limit key.
+  static inline const std::string REJECT_TAG{"reject"}; ///< Key for directives on rejection.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  Expr _key;                     ///< Key expression.
+  RateLimiter::Handle _limiter;  ///< Token buckets.
+  Directive::Handle _reject;     ///< Directives to invoke if over the limit.
+
+  Do_rate_limit(Expr &&key, RateLimiter::Handle &&limiter, Directive::Handle &&reject);
+};
+
+const HookMask Do_rate_limit::HOOKS{
+  MaskFor({Hook::TXN_START, Hook::CREQ, Hook::PRE_REMAP, Hook::REMAP, Hook::POST_REMAP, Hook::PREQ, Hook::URSP, Hook::PRSP})};
+
+Do_rate_limit::Do_rate_limit(Expr &&key, RateLimiter::Handle &&limiter, Directive::Handle &&reject)
+  : _key(std::move(key)), _limiter(std::move(limiter)), _reject(std::move(reject))
+{
+}
+
+Errata
+Do_rate_limit::invoke(Context &ctx)
+{
+  auto key = RateLimiter::hash_of(ctx, ctx.extract(_key));
+  if (!_limiter->consume(key) && _reject) {
+    return _reject->invoke(ctx);
+  }
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_rate_limit::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
+                    YAML::Node key_value)
+{
+  auto key_node = key_value[KEY_TAG];
+  if (!key_node) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key.)", KEY, drtv_node.Mark(), KEY_TAG);
+  }
+  auto &&[key_expr, key_errata]{cfg.parse_expr(key_node)};
+  if (!key_errata.is_ok()) {
+    key_errata.note(R"(While parsing "{}" key for "{}" directive at {}.)", KEY_TAG, KEY, drtv_node.Mark());
+    return std::move(key_errata);
+  }
+
+  auto &&[limiter, limiter_errata]{RateLimiter::load(cfg, key_value)};
+  if (!limiter_errata.is_ok()) {
+    limiter_errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+    return std::move(limiter_errata);
+  }
+
+  Directive::Handle reject;
+  if (auto reject_node = key_value[REJECT_TAG]; reject_node) {
+    auto &&[handle, errata]{cfg.parse_directive(reject_node)};
+    if (!errata.is_ok()) {
+      errata.note(R"(While parsing "{}" key for "{}" directive at {}.)", REJECT_TAG, KEY, drtv_node.Mark());
+      return std::move(errata);
+    }
+    reject = std::move(handle);
+  }
+
+  return Handle(new (cfg) self_type(std::move(key_expr), std::move(limiter), std::move(reject)));
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Rate limit comparison.
+ * The active feature is the key, the comparison matches if the key is over the limit.
+ */
+class Cmp_rate_limit : public Comparison
+{
+  using self_type  = Cmp_rate_limit; ///< Self reference type.
+  using super_type = Comparison;     ///< Parent type.
+public:
+  static inline const std::string KEY{"rate-limit"}; ///< Comparison name.
+  static const ValueMask TYPES;                      ///< Supported types.
+
+  bool operator()(Context &ctx, Feature const &feature) const override;
+
+  /// Construct an instance from YAML configuration.
+  static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
+
+protected:
+  RateLimiter::Handle _limiter; ///< Token buckets.
+
+  explicit Cmp_rate_limit(RateLimiter::Handle &&limiter) : _limiter(std::move(limiter)) {}
+};
+
+const ValueMask Cmp_rate_limit::TYPES{MaskFor({STRING, INTEGER, BOOLEAN, FLOAT, IP_ADDR, TUPLE})};
+
+bool
+Cmp_rate_limit::operator()(Context &ctx, Feature const &feature) const
+{
+  return !_limiter->consume(RateLimiter::hash_of(ctx, feature));
+}
+
+Rv<Comparison::Handle>
+Cmp_rate_limit::load(Config &cfg, YAML::Node const &cmp_node, TextView const &, TextView const &, YAML::Node value_node)
+{
+  auto &&[limiter, errata]{RateLimiter::load(cfg, value_node)};
+  if (!errata.is_ok()) {
+    errata.note(R"(While parsing "{}" comparison at {}.)", KEY, cmp_node.Mark());
+    return std::move(errata);
+  }
+  return Handle(new (cfg) self_type(std::move(limiter)));
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Limit the number of concurrent transactions per key.
+ *
+ * Counters are a fixed size array indexed by the key hash. Keys that collide share a counter,
+ * which can only cause extra rejections, never fewer. A counted transaction holds its count until
+ * the transaction context is destroyed at transaction close. The configuration (and therefore the
+ * counters) is guaranteed to outlive the context.
+ */
+class Do_concurrency_limit : public Directive
+{
+  using self_type  = Do_concurrency_limit; ///< Self reference type.
+  using super_type = Directive;            ///< Parent type.
+public:
+  static inline const std::string KEY{"concurrency-limit"}; ///< Directive name.
+  static const HookMask HOOKS;                              ///< Valid hooks for directive.
+
+  static inline const std::string KEY_TAG{"key"};       ///< Key for the limit key.
+  static inline const std::string LIMIT_TAG{"limit"};   ///< Key for the maximum count.
+  static inline const std::string SIZE_TAG{"size"};     ///< Key for the number of counters.
+  static inline const std::string STAT_TAG{"stat"};     ///< Key for rejection statistic.
+  static inline const std::string REJECT_TAG{"reject"}; ///< Key for directives on rejection.
+
+  static constexpr size_t DEFAULT_SIZE = 4096; ///< Default number of counters.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  using Counter = std::atomic<feature_type_for<INTEGER>>;
+
+  Expr _key;                          ///< Key expression.
+  feature_type_for<INTEGER> _limit;   ///< Maximum in flight transactions per key.
+  size_t _mask;                       ///< Mask for selecting a counter from a hash.
+  std::unique_ptr<Counter[]> _counts; ///< In flight counts.
+  Stat _rejected;                     ///< Rejection statistic.
+  Directive::Handle _reject;          ///< Directives to invoke if over the limit.
+
+  Do_concurrency_limit(Expr &&key, feature_type_for<INTEGER> limit, size_t size);
+};
+
+const HookMask Do_concurrency_limit::HOOKS{
+  MaskFor({Hook::TXN_START, Hook::CREQ, Hook::PRE_REMAP, Hook::REMAP, Hook::POST_REMAP, Hook::PREQ})};
+
+Do_concurrency_limit::Do_concurrency_limit(Expr &&key, feature_type_for<INTEGER> limit, size_t size)
+  : _key(std::move(key)), _limit(limit)
+{
+  // Round up to a power of 2 so a mask can be used.
+  size_t n = 1;
+  while (n < size) {
+    n <<= 1;
+  }
+  _mask = n - 1;
+  _counts.reset(new Counter[n]);
+  for (size_t idx = 0; idx < n; ++idx) {
+    _counts[idx].store(0, std::memory_order_relaxed);
+  }
+}
+
+Errata
+Do_concurrency_limit::invoke(Context &ctx)
+{
+  auto &count = _counts[RateLimiter::hash_of(ctx, ctx.extract(_key)) & _mask];
+  if (count.fetch_add(1, std::memory_order_relaxed) < _limit) {
+    // Counted - release it when the transaction is done.
+    ctx.mark_for_cleanup(&count, +[](Counter *c) { c->fetch_sub(1, std::memory_order_relaxed); });
+    return {};
+  }
+
+  // Over the limit - back out and do the fallback.
+  count.fetch_sub(1, std::memory_order_relaxed);
+  if (_rejected.is_set()) {
+    _rejected.update(1);
+  }
+  if (_reject) {
+    return _reject->invoke(ctx);
+  }
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_concurrency_limit::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &,
+                           swoc::TextView const &, YAML::Node key_value)
+{
+  if (!key_value.IsMap()) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a map as its value.)", KEY, drtv_node.Mark());
+  }
+
+  auto key_node = key_value[KEY_TAG];
+  if (!key_node) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key.)", KEY, drtv_node.Mark(), KEY_TAG);
+  }
+  auto &&[key_expr, key_errata]{cfg.parse_expr(key_node)};
+  if (!key_errata.is_ok()) {
+    key_errata.note(R"(While parsing "{}" key for "{}" directive at {}.)", KEY_TAG, KEY, drtv_node.Mark());
+    return std::move(key_errata);
+  }
+
+  if (!key_value[LIMIT_TAG]) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key.)", KEY, drtv_node.Mark(), LIMIT_TAG);
+  }
+  feature_type_for<INTEGER> limit = 0;
+  feature_type_for<INTEGER> size  = DEFAULT_SIZE;
+  auto errata                     = RateLimiter::load_integer(cfg, key_value, LIMIT_TAG, limit);
+  errata.note(RateLimiter::load_integer(cfg, key_value, SIZE_TAG, size));
+  if (!errata.is_ok()) {
+    errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+    return std::move(errata);
+  }
+
+  auto self = new (cfg) self_type(std::move(key_expr), limit, size);
+  Handle handle(self);
+
+  if (auto stat_node = key_value[STAT_TAG]; stat_node) {
+    if (!stat_node.IsScalar()) {
+      return Errata(S_ERROR, R"("{}" value at {} must be the name of a statistic.)", STAT_TAG, stat_node.Mark());
+    }
+    self->_rejected.assign(cfg, stat_node.Scalar());
+  }
+
+  if (auto reject_node = key_value[REJECT_TAG]; reject_node) {
+    auto &&[reject, reject_errata]{cfg.parse_directive(reject_node)};
+    if (!reject_errata.is_ok()) {
+      reject_errata.note(R"(While parsing "{}" key for "{}" directive at {}.)", REJECT_TAG, KEY, drtv_node.Mark());
+      return std::move(reject_errata);
+    }
+    self->_reject = std::move(reject);
+  }
+
+  return handle;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+namespace
+{
+[[maybe_unused]] bool INITIALIZED = []() -> bool {
+  Config::define<Do_rate_limit>();
+  Config::define<Do_concurrency_limit>();
+  Comparison::define(Cmp_rate_limit::KEY, Cmp_rate_limit::TYPES, Cmp_rate_limit::load);
+  return true;
+}();
+} // namespace
@@ -7,6 +7,10 @@
 
 #include "txn_box/common.h"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <swoc/TextView.h>
@@ -16,6 +20,7 @@
 #include "txn_box/Config.h"
 #include "txn_box/Directive.h"
 #include "txn_box/Context.h"
+#include "txn_box/Stat.h"
 
 #include "txn_box/ts_util.h"
 
@@ -127,7 +132,7 @@ Rv<Directive::Handle>
 Do_stat_define::load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
                      YAML::Node key_value)
 {
-  auto self = new self_type();
+  auto self = new (cfg) self_type();
   Handle handle(self);
 
   // Prefix is optional - defaults to "plugin.txn_box"
@@ -217,55 +222,25 @@ Do_stat_define::load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_nod
   return handle;
 }
 /* ------------------------------------------------------------------------------------ */
-/// Statistic information.
-/// The name is used when it can't be resolved during configuration loading.
-struct Stat {
-  static constexpr int UNRESOLVED = -1;
-  static constexpr int INVALID    = -2;
-  TextView _name;        ///< Statistic name.
-  int _idx = UNRESOLVED; ///< Statistic index.
-
-  Stat(Config &cfg, TextView const &name) { this->assign(cfg, name); }
-
-  Stat &
-  assign(Config &cfg, TextView name)
-  {
-    _name = Do_stat_define::expand_and_localize(cfg, name);
-
-    _idx = ts::plugin_stat_index(_name);
-    _idx = _idx < 0 ? UNRESOLVED : _idx; // normalize.
-    return *this;
-  }
-
-  int
-  index()
-  {
-    if (_idx == UNRESOLVED) {
-      _idx = ts::plugin_stat_index(_name);
-      if (_idx < 0) { // On a lookup failure, give up and prevent future lookups.
-        _idx = INVALID;
+Stat &
+Stat::assign(Config &cfg, TextView name)
+{
+  _name = Do_stat_define::expand_and_localize(cfg, name);
+
+  _idx = ts::plugin_stat_index(_name);
+  if (_idx < 0) {
+    _idx = UNRESOLVED; // normalize.
+    // Try again before the configuration is active, but only if found - it may be defined later.
+    cfg.on_warm_up([this]() -> void {
+      if (_idx == UNRESOLVED) {
+        if (auto idx = ts::plugin_stat_index(_name); idx >= 0) {
+          _idx = idx;
+        }
       }
-    }
-    return _idx;
-  }
-
-  Feature
-  value()
-  {
-    auto n{this->index()};
-    return n < 0 ? NIL_FEATURE : feature_type_for<INTEGER>{ts::plugin_stat_value(_idx)};
-  }
-
-  Stat &
-  update(feature_type_for<INTEGER> value)
-  {
-    auto n{this->index()};
-    if (n >= 0) {
-      ts::plugin_stat_update(n, value);
-    }
-    return *this;
+    });
   }
-};
+  return *this;
+}
 /* ------------------------------------------------------------------------------------ */
 class Do_stat_update : public Directive
 {
@@ -318,7 +293,7 @@ Do_stat_update::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, s
                      YAML::Node key_value)
 {
   if (key_value.IsNull()) {
-    return Handle(new self_type(cfg, arg, Expr{feature_type_for<INTEGER>(1)}));
+    return Handle(new (cfg) self_type(cfg, arg, Expr{feature_type_for<INTEGER>(1)}));
   }
 
   auto &&[expr, errata]{cfg.parse_expr(key_value)};
@@ -330,7 +305,7 @@ Do_stat_update::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, s
     return Errata(S_ERROR,"Value for {} directive at {} must be an integer.", KEY, drtv_node.Mark());
   }
 
-  return Handle(new self_type{cfg, arg, std::move(expr)});
+  return Handle(new (cfg) self_type{cfg, arg, std::move(expr)});
 }
 /* ------------------------------------------------------------------------------------ */
 class Ex_stat : public Extractor
@@ -369,6 +344,242 @@ Ex_stat::format(BufferWriter &w, Spec const &spec, Context &ctx)
   return bwformat(w, spec, this->extract(ctx, spec));
 }
 
+/* ------------------------------------------------------------------------------------ */
+/** Reply with a snapshot of the plugin statistics and configuration information.
+ *
+ * Gathering the statistics takes the record locks, so it is done in a background task and the
+ * result cached. A transaction only copies the most recent snapshot, and if that is older than
+ * the update period a refresh is scheduled. The first snapshot is rendered when the configuration
+ * is warmed up, so a transaction never renders one.
+ */
+class Do_stats_reply : public Directive
+{
+  using self_type  = Do_stats_reply; ///< Self reference type.
+  using super_type = Directive;      ///< Parent type.
+  using Clock      = std::chrono::steady_clock;
+
+public:
+  static inline const std::string KEY{"stats-reply"}; ///< Directive name.
+  static const HookMask HOOKS;                        ///< Valid hooks for directive.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  /// Output format.
+  enum Format { PROMETHEUS, JSON };
+
+  Format _format = PROMETHEUS;                       ///< Output format.
+  TextView _prefix{"plugin.txn_box"};                ///< Only stats with this prefix are reported.
+  Clock::duration _period = std::chrono::seconds{1}; ///< Maximum age of the snapshot.
+
+  std::mutex _snapshot_mutex;             ///< Protects @a _snapshot and @a _snapshot_time.
+  std::shared_ptr<std::string> _snapshot; ///< Rendered output.
+  Clock::time_point _snapshot_time;       ///< When @a _snapshot was rendered.
+  std::atomic<bool> _refresh_p{false};    ///< Set if a refresh task is scheduled.
+
+  static inline const std::string FORMAT_TAG{"format"};
+  static inline const std::string PREFIX_TAG{"prefix"};
+  static inline const std::string PERIOD_TAG{"period"};
+
+  /// Format names.
+  static inline const swoc::Lexicon<Format> FormatNames{{{PROMETHEUS, "prometheus"}, {JSON, "json"}}, PROMETHEUS};
+
+  Do_stats_reply() = default;
+
+  /// Render a snapshot for @a cfg and make it current.
+  std::shared_ptr<std::string> refresh(Config const &cfg);
+
+  /// Schedule a background refresh for @a cfg, if one is not already scheduled.
+  void schedule_refresh(std::shared_ptr<Config> cfg);
+
+  /// Write @a name as a Prometheus metric name.
+  static void prometheus_name(BufferWriter &w, TextView name);
+};
+
+// Not valid on remap - the snapshot refresh task must be able to hold a reference to the global
+// configuration, which a remap only transaction does not have.
+const HookMask Do_stats_reply::HOOKS{MaskFor({Hook::CREQ, Hook::PRE_REMAP})};
+
+void
+Do_stats_reply::prometheus_name(BufferWriter &w, TextView name)
+{
+  for (char c : name) {
+    w.write(isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':' ? c : '_');
+  }
+}
+
+std::shared_ptr<std::string>
+Do_stats_reply::refresh(Config const &cfg)
+{
+  auto text = std::make_shared<std::string>();
+  swoc::LocalBufferWriter<1024> w;
+  auto flush = [&]() {
+    text->append(w.view());
+    w.clear();
+  };
+
+  bool first_p = true;
+  if (_format == JSON) {
+    w.write(R"({"config":{"generation":)"_tv).print("{}", cfg.generation()).write(R"(,"files":[)"_tv);
+    for (auto const &[path, t] : cfg.file_load_times()) {
+      w.write(first_p ? "{"_tv : ",{"_tv).write(R"("path":)"_tv);
+      json_string(w, path.view());
+      w.write(R"(,"load_ns":)"_tv).print("{}", t.count()).write('}');
+      first_p = false;
+      flush();
+    }
+    w.write(R"(]},"stats":{)"_tv);
+    first_p = true;
+    ts::plugin_stat_dump([&](TextView name, intmax_t value) {
+      if (name.starts_with(_prefix)) {
+        w.write(first_p ? ""_tv : ","_tv);
+        json_string(w, name).print(":{}", value);
+        first_p = false;
+        flush();
+      }
+    });
+    w.write("}}\n"_tv);
+  } else {
+    w.print("txn_box_config_generation {}\n", cfg.generation());
+    for (auto const &[path, t] : cfg.file_load_times()) {
+      w.write(R"(txn_box_config_file_load_ns{path=")"_tv);
+      for (char c : path.view()) {
+        if (c == '"' || c == '\\') {
+          w.write('\\').write(c);
+        } else if (c == '\n') {
+          w.write("\\n"_tv);
+        } else {
+          w.write(c);
+        }
+      }
+      w.write("\"} "_tv).print("{}\n", t.count());
+      flush();
+    }
+    ts::plugin_stat_dump([&](TextView name, intmax_t value) {
+      if (name.starts_with(_prefix)) {
+        prometheus_name(w, name);
+        w.print(" {}\n", value);
+        flush();
+      }
+    });
+  }
+  flush();
+
+  std::lock_guard lock(_snapshot_mutex);
+  _snapshot      = text;
+  _snapshot_time = Clock::now();
+  return text;
+}
+
+void
+Do_stats_reply::schedule_refresh(std::shared_ptr<Config> cfg)
+{
+  if (cfg && !_refresh_p.exchange(true)) {
+    // The task holds a reference to the configuration, which keeps @a this valid.
+    ts::PerformAsTask([this, cfg = std::move(cfg)]() -> void {
+      this->refresh(*cfg);
+      _refresh_p = false;
+    });
+  }
+}
+
+Errata
+Do_stats_reply::invoke(Context &ctx)
+{
+  std::shared_ptr<std::string> snapshot;
+  bool stale_p;
+  {
+    std::lock_guard lock(_snapshot_mutex);
+    snapshot = _snapshot;
+    stale_p  = Clock::now() - _snapshot_time > _period;
+  }
+
+  if (!snapshot) { // Not warmed up - don't render on a transaction thread.
+    this->schedule_refresh(ctx.acquire_cfg());
+    ctx._txn.status_set(TS_HTTP_STATUS_SERVICE_UNAVAILABLE);
+    ctx._txn.error_body_set("Statistics are not yet available.\n"_tv, "text/plain"_tv);
+    return {};
+  }
+  if (stale_p) {
+    this->schedule_refresh(ctx.acquire_cfg());
+  }
+
+  ctx._txn.status_set(TS_HTTP_STATUS_OK);
+  ctx._txn.error_body_set(*snapshot, _format == JSON ? "application/json"_tv : "text/plain; version=0.0.4"_tv);
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_stats_reply::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
+                     YAML::Node key_value)
+{
+  auto self = new (cfg) self_type();
+  Handle handle(self);
+
+  if (key_value.IsNull()) {
+    cfg.on_warm_up([self, &cfg]() -> void { self->refresh(cfg); });
+    return handle; // all defaults.
+  }
+  if (!key_value.IsMap()) {
+    return Errata(S_ERROR, R"(Value for "{}" directive at {} must be empty or a map.)", KEY, drtv_node.Mark());
+  }
+
+  if (auto format_node = key_value[FORMAT_TAG]; format_node) {
+    auto format = FormatNames[TextView{format_node.Scalar()}];
+    if (format_node.Scalar() != FormatNames[format]) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} must be "{}" or "{}".)", FORMAT_TAG, format_node.Mark(),
+                    KEY, drtv_node.Mark(), FormatNames[PROMETHEUS], FormatNames[JSON]);
+    }
+    self->_format = format;
+  }
+
+  if (auto prefix_node = key_value[PREFIX_TAG]; prefix_node) {
+    if (!prefix_node.IsScalar()) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} must be a literal string.)", PREFIX_TAG,
+                    prefix_node.Mark(), KEY, drtv_node.Mark());
+    }
+    self->_prefix = cfg.localize(TextView{prefix_node.Scalar()});
+  }
+
+  if (auto period_node = key_value[PERIOD_TAG]; period_node) {
+    auto &&[expr, errata]{cfg.parse_expr(period_node)};
+    if (!errata.is_ok()) {
+      errata.note(R"(While parsing "{}" value at {} for "{}" directive at {}.)", PERIOD_TAG, period_node.Mark(), KEY,
+                  drtv_node.Mark());
+      return std::move(errata);
+    }
+    if (!expr.is_literal()) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} must be a literal duration.)", PERIOD_TAG,
+                    period_node.Mark(), KEY, drtv_node.Mark());
+    }
+    auto &&[period, period_errata]{std::get<Expr::LITERAL>(expr._raw).as_duration()};
+    if (!period_errata.is_ok()) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} is not a valid duration.)", PERIOD_TAG,
+                    period_node.Mark(), KEY, drtv_node.Mark());
+    }
+    self->_period = period;
+  }
+
+  // Render the first snapshot before the configuration is active. @a cfg is still being loaded at
+  // this point so the snapshot can't be rendered yet.
+  cfg.on_warm_up([self, &cfg]() -> void { self->refresh(cfg); });
+
+  return handle;
+}
+
 /* ------------------------------------------------------------------------------------ */
 
 namespace
@@ -378,6 +589,7 @@ Ex_stat stat;
 [[maybe_unused]] bool INITIALIZED = []() -> bool {
   Config::define<Do_stat_define>();
   Config::define<Do_stat_update>();
+  Config::define<Do_stats_reply>();
   Extractor::define(Ex_stat::NAME, &stat);
   return true;
 }();
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: Apache-2.0
 */
 
+#include <ctime>
 #include <shared_mutex>
 
 #include "txn_box/common.h"
@@ -91,13 +92,24 @@ protected:
     MapHandle _map; ///< Map of names to specific text block definitions.
   };
 
+  /// Block content, with validators computed when the content is loaded.
+  struct Content {
+    std::string _text;          ///< Content.
+    time_t _mtime = 0;          ///< Last modified time.
+    std::string _etag;          ///< Entity tag.
+    std::string _last_modified; ///< @a _mtime as an HTTP date.
+
+    Content(std::string &&text, Clock::time_point mtime);
+  };
+
   TextView _name;                                                             ///< Block name.
   swoc::file::path _path;                                                     ///< Path to file (optional)
   std::optional<TextView> _text;                                              ///< Default literal text (optional)
   feature_type_for<DURATION> _duration;                                       ///< Time between update checks.
   std::atomic<Clock::duration> _last_check = Clock::now().time_since_epoch(); ///< Absolute time of the last alert.
   Clock::time_point _last_modified;                                           ///< Last modified time of the file.
-  std::shared_ptr<std::string> _content;                                      ///< Content of the file.
+  std::shared_ptr<Content> _content;                                          ///< Content of the file.
+  std::shared_ptr<Content> _text_content;                                     ///< @a _text as content, for @c static-file.
   int _line_no = 0;                                                           ///< For debugging name conflicts.
   std::shared_mutex _content_mutex;                                           ///< Lock for access @a content.
   ts::TaskHandle _task;                                                       ///< Handle for periodic checking task.
@@ -118,17 +130,44 @@ protected:
 
   Do_text_block_define() = default;
 
+  /// @return The current content, or @c nullptr if there is none.
+  std::shared_ptr<Content> content();
+
   friend class Ex_text_block;
+  friend class Do_static_file;
   friend Updater;
 };
 
 const HookMask Do_text_block_define::HOOKS{MaskFor(Hook::POST_LOAD)};
 
+Do_text_block_define::Content::Content(std::string &&text, Clock::time_point mtime)
+  : _text(std::move(text)), _mtime(Clock::to_time_t(mtime))
+{
+  // Strong validator - if the content changes, so will the hash or the size.
+  swoc::bwprint(_etag, R"("{:x}-{:x}")", Hash64FNV1a(_text), _text.size());
+  std::tm tm;
+  gmtime_r(&_mtime, &tm);
+  char buff[64];
+  _last_modified.assign(buff, strftime(buff, sizeof(buff), "%a, %d %b %Y %H:%M:%S GMT", &tm));
+}
+
 Do_text_block_define::~Do_text_block_define() noexcept
 {
   _task.cancel();
 }
 
+auto
+Do_text_block_define::content() -> std::shared_ptr<Content>
+{
+  {
+    std::shared_lock lock(_content_mutex);
+    if (_content) {
+      return _content;
+    }
+  }
+  return _text_content;
+}
+
 auto
 Do_text_block_define::map(Directive::CfgStaticData const *rtti) -> Map *
 {
@@ -150,7 +189,7 @@ Rv<Directive::Handle>
 Do_text_block_define::load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &,
                            swoc::TextView const &, YAML::Node key_value)
 {
-  auto self = new self_type();
+  auto self = new (cfg) self_type();
   Handle handle(self);
   auto &fg       = self->_fg;
   self->_line_no = drtv_node.Mark().line;
@@ -206,18 +245,23 @@ Do_text_block_define::load(Config &cfg, CfgStaticData const *rtti, YAML::Node dr
 
   self->_notify_idx = fg.index_of(NOTIFY_TAG);
 
+  if (self->_text.has_value()) {
+    self->_text_content = std::make_shared<Content>(std::string{self->_text.value()}, Clock::now());
+  }
+
   if (!self->_path.empty()) {
     std::error_code ec;
     auto content = swoc::file::load(self->_path, ec);
     if (!ec) {
-      self->_content = std::make_shared<std::string>(std::move(content));
+      self->_last_modified = swoc::file::modify_time(swoc::file::status(self->_path, ec));
+      self->_content       = std::make_shared<Content>(std::move(content), self->_last_modified);
     } else if (self->_text.has_value()) {
-      self->_content = nullptr;
+      self->_content       = nullptr;
+      self->_last_modified = swoc::file::modify_time(swoc::file::status(self->_path, ec));
     } else {
       return Errata(S_ERROR, R"("{}" directive at {} - value "{}" for key "{}" is not readable [{}] and no alternate "{}" key was present.)",
                    KEY, drtv_node.Mark(), self->_path, PATH_TAG, ec, TEXT_TAG);
     }
-    self->_last_modified = swoc::file::modify_time(swoc::file::status(self->_path, ec));
   }
 
   // Put the directive in the map.
@@ -263,9 +307,9 @@ Do_text_block_define::Updater::operator()()
     if (mtime <= _block->_last_modified) {
       return; // same as it ever was...
     }
-    auto content = std::make_shared<std::string>();
-    *content     = swoc::file::load(_block->_path, ec);
+    auto text = swoc::file::load(_block->_path, ec);
     if (!ec) { // swap in updated content.
+      auto content = std::make_shared<Content>(std::move(text), mtime);
       {
         std::unique_lock lock(_block->_content_mutex);
         _block->_content       = content;
@@ -327,7 +371,7 @@ Ex_text_block::extract(Context &ctx, const Spec &spec)
       // This needs to persist until the end of the invoking directive. There's no direct
       // support for that so the best that can be done is to persist until the end of the
       // transaction by putting it in context storage.
-      std::shared_ptr<std::string> &content = *(ctx.make<std::shared_ptr<std::string>>());
+      auto &content = *(ctx.make<std::shared_ptr<Do_text_block_define::Content>>());
 
       { // grab a copy of the shared pointer to file content.
         std::shared_lock lock(block->_content_mutex);
@@ -336,7 +380,7 @@ Ex_text_block::extract(Context &ctx, const Spec &spec)
 
       if (content) {
         ctx.mark_for_cleanup(&content); // only need to cleanup if non-nullptr.
-        return FeatureView{*content};
+        return FeatureView{content->_text};
       }
       // No file content, see if there's alternate text.
       if (block->_text.has_value()) {
@@ -354,6 +398,315 @@ Ex_text_block::format(BufferWriter &w, Spec const &spec, Context &ctx)
   return bwformat(w, spec, this->extract(ctx, spec));
 }
 
+/* ------------------------------------------------------------------------------------ */
+/** Serve the content of a text block as the proxy response.
+ *
+ * The response is validated against the request - a matching @c If-None-Match or
+ * @c If-Modified-Since yields a 304, and a single @c Range yields a 206 with that slice of the
+ * content. The validators are computed when the content is loaded, not per transaction.
+ */
+class Do_static_file : public Directive
+{
+  using self_type  = Do_static_file; ///< Self reference type.
+  using super_type = Directive;      ///< Parent type.
+
+  /// Per configuration storage.
+  struct CfgInfo {
+    ReservedSpan _ctx_span; ///< Reserved span for @c CtxInfo.
+  };
+
+  /// Per context information, for the fields set in the proxy response.
+  struct CtxInfo {
+    TextView _etag;          ///< ETag value.
+    TextView _last_modified; ///< Last-Modified value.
+    TextView _content_range; ///< Content-Range value, empty if not a range response.
+  };
+
+public:
+  static inline const std::string KEY{"static-file"}; ///< Directive name.
+  static const HookMask HOOKS;                        ///< Valid hooks for directive.
+
+  /// Specify the required amount of reserved configuration storage.
+  static constexpr Options OPTIONS{sizeof(CfgInfo)};
+
+  /// Response fields are set on this hook.
+  static constexpr Hook FIXUP_HOOK = Hook::PRSP;
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+  /// Configuration level initialization.
+  static Errata cfg_init(Config &cfg, CfgStaticData const *rtti);
+
+protected:
+  using Content = Do_text_block_define::Content;
+
+  TextView _name;     ///< Text block name.
+  Expr _content_type; ///< Content type, empty for the default.
+  /// Bounce from fixup hook directive back to @a this.
+  LambdaDirective _fixup{[this](Context &ctx) -> Errata { return this->fixup(ctx); }};
+
+  static inline const std::string TEXT_BLOCK_TAG{"text-block"};
+  static inline const std::string CONTENT_TYPE_TAG{"content-type"};
+  static constexpr TextView DEFAULT_CONTENT_TYPE{"application/octet-stream"};
+
+  /// Result of checking the @c Range field.
+  enum RangeResult {
+    FULL,         ///< No range, or a range that can't be honored - send the full content.
+    PARTIAL,      ///< Send the range.
+    UNSATISFIABLE ///< Range does not overlap the content.
+  };
+
+  /// @return @c true if the validators in the request match @a content.
+  static bool not_modified(ts::HttpRequest const &req, Content const &content);
+
+  /** Check for a range request.
+   *
+   * @param req Client request.
+   * @param content Response content.
+   * @param[out] range The range, if the result is @c PARTIAL.
+   * @return The type of response to send.
+   *
+   * Only a single range is supported. Multiple ranges are ignored and the full content is sent,
+   * which is permitted by RFC 7233.
+   */
+  static RangeResult range_for(ts::HttpRequest const &req, Content const &content, std::pair<size_t, size_t> &range);
+
+  /// Set response fields.
+  Errata fixup(Context &ctx);
+};
+
+// Not valid on remap - text blocks are defined only in the global configuration, which a remap only
+// transaction does not have.
+const HookMask Do_static_file::HOOKS{MaskFor({Hook::CREQ, Hook::PRE_REMAP})};
+
+Errata
+Do_static_file::cfg_init(Config &cfg, CfgStaticData const *rtti)
+{
+  auto cfg_info = rtti->_cfg_store.rebind<CfgInfo>().data();
+  new (cfg_info) CfgInfo;
+  // Only one static file response can be effective per transaction.
+  cfg_info->_ctx_span = cfg.reserve_ctx_storage(sizeof(CtxInfo));
+  cfg.reserve_slot(FIXUP_HOOK);
+  return {};
+}
+
+bool
+Do_static_file::not_modified(ts::HttpRequest const &req, Content const &content)
+{
+  // If-None-Match takes precedence, and If-Modified-Since is ignored if it is present.
+  if (auto field = req.field(ts::HTTP_FIELD_IF_NONE_MATCH); field.is_valid()) {
+    for (; field.is_valid(); field = field.next_dup()) {
+      TextView value = field.value();
+      while (value) {
+        auto tag = value.take_prefix_at(',').trim_if(&isspace);
+        if (tag.starts_with("W/"_tv)) { // weak comparison.
+          tag.remove_prefix(2);
+        }
+        if (tag == "*"_tv || tag == content._etag) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+  if (auto field = req.field(ts::HTTP_FIELD_IF_MODIFIED_SINCE); field.is_valid()) {
+    std::string text{field.value()}; // need a C string.
+    std::tm tm{};
+    if (auto end = strptime(text.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm); end != nullptr) {
+      return content._mtime <= timegm(&tm);
+    }
+  }
+  return false;
+}
+
+auto
+Do_static_file::range_for(ts::HttpRequest const &req, Content const &content, std::pair<size_t, size_t> &range) -> RangeResult
+{
+  auto field = req.field(ts::HTTP_FIELD_RANGE);
+  if (!field.is_valid() || req.method() != "GET"_tv) {
+    return FULL;
+  }
+  // If-Range - only honor the range if the content has not changed.
+  if (auto if_range = req.field(ts::HTTP_FIELD_IF_RANGE); if_range.is_valid()) {
+    auto value = if_range.value().trim_if(&isspace);
+    if (value != content._etag && value != content._last_modified) {
+      return FULL;
+    }
+  }
+
+  auto spec = field.value().trim_if(&isspace);
+  if (!spec.starts_with_nocase("bytes="_tv)) {
+    return FULL;
+  }
+  spec.remove_prefix(6);
+  if (spec.find(',') != TextView::npos || spec.find('-') == TextView::npos) {
+    return FULL;
+  }
+  auto first = spec.take_prefix_at('-').trim_if(&isspace);
+  spec.trim_if(&isspace);
+
+  size_t size = content._text.size();
+  TextView parsed;
+  if (first.empty()) { // suffix range - last N bytes.
+    auto n = swoc::svtou(spec, &parsed);
+    if (spec.empty() || parsed.size() != spec.size()) {
+      return FULL;
+    }
+    if (n == 0 || size == 0) {
+      return UNSATISFIABLE;
+    }
+    range = {size - std::min<size_t>(n, size), size - 1};
+    return PARTIAL;
+  }
+
+  auto start = swoc::svtou(first, &parsed);
+  if (parsed.size() != first.size()) {
+    return FULL;
+  }
+  size_t last = size - 1;
+  if (!spec.empty()) {
+    auto n = swoc::svtou(spec, &parsed);
+    if (parsed.size() != spec.size() || n < start) {
+      return FULL; // invalid range specification is ignored.
+    }
+    last = std::min<size_t>(n, last);
+  }
+  if (start >= size) {
+    return UNSATISFIABLE;
+  }
+  range = {start, last};
+  return PARTIAL;
+}
+
+Errata
+Do_static_file::invoke(Context &ctx)
+{
+  auto rtti = ctx.cfg().drtv_info(Do_text_block_define::KEY);
+  if (rtti == nullptr) {
+    return {};
+  }
+  auto map  = Do_text_block_define::map(rtti);
+  auto spot = map->find(_name);
+  if (spot == map->end()) {
+    return {};
+  }
+  auto block = spot->second;
+  // The content must persist until the response body is set, and the validators until the
+  // response fields are set, so keep a reference in the context.
+  auto &content = *(ctx.make<std::shared_ptr<Content>>());
+  content       = block->content();
+  if (!content) {
+    return {}; // nothing to serve, let the transaction proceed normally.
+  }
+  ctx.mark_for_cleanup(&content);
+
+  auto cfg_info = _rtti->_cfg_store.rebind<CfgInfo>().data();
+  auto ctx_info = ctx.initialized_storage_for<CtxInfo>(cfg_info->_ctx_span).data();
+  bool need_hook_p = ctx_info->_etag.empty(); // hook needed if this is the first to set up the response.
+  ctx_info->_etag          = content->_etag;
+  ctx_info->_last_modified = content->_last_modified;
+  ctx_info->_content_range = TextView{};
+
+  TextView content_type = DEFAULT_CONTENT_TYPE;
+  if (!_content_type.empty()) {
+    if (auto view = ctx.extract_view(_content_type); !view.empty()) {
+      content_type = view;
+    }
+  }
+
+  auto req{ctx.ua_req_hdr()};
+  TextView body{content->_text};
+  std::pair<size_t, size_t> range;
+  if (not_modified(req, *content)) {
+    ctx._txn.status_set(TS_HTTP_STATUS_NOT_MODIFIED);
+    body.clear();
+  } else if (auto rr = range_for(req, *content, range); rr == PARTIAL) {
+    ctx._txn.status_set(TS_HTTP_STATUS_PARTIAL_CONTENT);
+    body                     = body.substr(range.first, range.second - range.first + 1);
+    ctx_info->_content_range = ctx.commit(ctx.render_transient(
+      [&](BufferWriter &w) { w.print("bytes {}-{}/{}", range.first, range.second, content->_text.size()); }));
+  } else if (rr == UNSATISFIABLE) {
+    ctx._txn.status_set(TS_HTTP_STATUS_REQUESTED_RANGE_NOT_SATISFIABLE);
+    body.clear();
+    ctx_info->_content_range =
+      ctx.commit(ctx.render_transient([&](BufferWriter &w) { w.print("bytes */{}", content->_text.size()); }));
+  } else {
+    ctx._txn.status_set(TS_HTTP_STATUS_OK);
+  }
+
+  // The body goes directly from the shared content to the response buffer, no intermediate copy.
+  if (!body.empty()) {
+    ctx._txn.error_body_set(body, content_type);
+  }
+
+  if (need_hook_p) {
+    ctx.on_hook_do(FIXUP_HOOK, &_fixup);
+  }
+  return {};
+}
+
+Errata
+Do_static_file::fixup(Context &ctx)
+{
+  auto cfg_info = _rtti->_cfg_store.rebind<CfgInfo>().data();
+  auto ctx_info = ctx.storage_for(cfg_info->_ctx_span).rebind<CtxInfo>().data();
+  auto hdr{ctx.proxy_rsp_hdr()};
+  hdr.field_obtain(ts::HTTP_FIELD_ETAG).assign(ctx_info->_etag);
+  hdr.field_obtain(ts::HTTP_FIELD_LAST_MODIFIED).assign(ctx_info->_last_modified);
+  hdr.field_obtain(ts::HTTP_FIELD_ACCEPT_RANGES).assign("bytes"_tv);
+  if (!ctx_info->_content_range.empty()) {
+    hdr.field_obtain(ts::HTTP_FIELD_CONTENT_RANGE).assign(ctx_info->_content_range);
+  }
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_static_file::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
+                     YAML::Node key_value)
+{
+  auto self = new (cfg) self_type;
+  Handle handle(self);
+
+  YAML::Node name_node;
+  if (key_value.IsScalar()) {
+    name_node = key_value;
+  } else if (key_value.IsMap()) {
+    name_node = key_value[TEXT_BLOCK_TAG];
+    if (auto ct_node = key_value[CONTENT_TYPE_TAG]; ct_node) {
+      auto &&[expr, errata]{cfg.parse_expr(ct_node)};
+      if (!errata.is_ok()) {
+        errata.note(R"(While parsing "{}" key at {} in "{}" directive at {}.)", CONTENT_TYPE_TAG, ct_node.Mark(), KEY,
+                    drtv_node.Mark());
+        return std::move(errata);
+      }
+      if (!expr.result_type().can_satisfy(STRING)) {
+        return Errata(S_ERROR, R"("{}" value at {} must be a string.)", CONTENT_TYPE_TAG, ct_node.Mark());
+      }
+      self->_content_type = std::move(expr);
+    }
+  }
+  if (!name_node || !name_node.IsScalar() || name_node.Scalar().empty()) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have the name of a text block as its value or as the value of the "{}" key.)",
+                  KEY, drtv_node.Mark(), TEXT_BLOCK_TAG);
+  }
+  self->_name = cfg.localize(TextView{name_node.Scalar()});
+
+  return handle;
+}
+
 /* ------------------------------------------------------------------------------------ */
 
 namespace
@@ -362,6 +715,7 @@ Ex_text_block text_block;
 
 [[maybe_unused]] bool INITIALIZED = []() -> bool {
   Config::define<Do_text_block_define>();
+  Config::define<Do_static_file>();
   Extractor::define(Ex_text_block::NAME, &text_block);
   return true;
 }();
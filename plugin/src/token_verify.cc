@@ -0,0 +1,877 @@
+/** @file
+   Signed token verification - JWT and signed URLs.
+
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include "txn_box/common.h"
+
+#include <swoc/TextView.h>
+#include <swoc/Errata.h>
+#include <swoc/BufferWriter.h>
+#include <swoc/bwf_base.h>
+
+#include "txn_box/Comparison.h"
+#include "txn_box/Extractor.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+#include "txn_box/ShardedLRU.h"
+
+#include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
+
+using swoc::TextView;
+using swoc::MemSpan;
+using swoc::Errata;
+using swoc::Rv;
+using swoc::BufferWriter;
+using namespace swoc::literals;
+using Clock = std::chrono::system_clock;
+
+namespace
+{
+/// Name of the reserved context storage for the verified JWT payload.
+constexpr TextView JWT_CTX_KEY{"jwt-verify"};
+
+/** Find the extent of the JSON value at the start of @a src.
+ *
+ * @param src JSON text, updated to start after the value.
+ * @return The value text, or an empty view if it is malformed.
+ */
+TextView
+json_take_value(TextView &src)
+{
+  src.ltrim_if(&isspace);
+  if (src.empty()) {
+    return {};
+  }
+  size_t idx = 0;
+  if (src[0] == '"') {
+    for (idx = 1; idx < src.size() && src[idx] != '"'; ++idx) {
+      if (src[idx] == '\\') {
+        ++idx;
+      }
+    }
+    if (idx >= src.size()) {
+      return {};
+    }
+    ++idx; // include closing quote.
+  } else if (src[0] == '{' || src[0] == '[') {
+    int depth = 0;
+    for (; idx < src.size(); ++idx) {
+      char c = src[idx];
+      if (c == '"') {
+        for (++idx; idx < src.size() && src[idx] != '"'; ++idx) {
+          if (src[idx] == '\\') {
+            ++idx;
+          }
+        }
+      } else if (c == '{' || c == '[') {
+        ++depth;
+      } else if ((c == '}' || c == ']') && --depth == 0) {
+        break;
+      }
+    }
+    if (idx >= src.size()) {
+      return {};
+    }
+    ++idx;
+  } else {
+    while (idx < src.size() && src[idx] != ',' && src[idx] != '}' && src[idx] != ']' && !isspace(src[idx])) {
+      ++idx;
+    }
+  }
+  return src.take_prefix(idx);
+}
+
+/** Find a top level member of a JSON object.
+ *
+ * @param json JSON object text.
+ * @param name Member name.
+ * @return The raw JSON text of the member value, or an empty view if not found.
+ *
+ * Member names are compared without unescaping, which is sufficient for registered claim names.
+ */
+TextView
+json_member(TextView json, TextView name)
+{
+  json.trim_if(&isspace);
+  if (!json.starts_with("{"_tv)) {
+    return {};
+  }
+  json.remove_prefix(1);
+  while (true) {
+    auto key = json_take_value(json);
+    if (key.size() < 2 || key[0] != '"') {
+      return {};
+    }
+    json.ltrim_if(&isspace);
+    if (!json.starts_with(":"_tv)) {
+      return {};
+    }
+    json.remove_prefix(1);
+    auto value = json_take_value(json);
+    if (value.empty()) {
+      return {};
+    }
+    if (key.substr(1, key.size() - 2) == name) {
+      return value;
+    }
+    json.ltrim_if(&isspace);
+    if (!json.starts_with(","_tv)) {
+      return {};
+    }
+    json.remove_prefix(1);
+  }
+}
+
+/// @return The JSON string @a value without quotes, or empty if it is not a string without escapes.
+TextView
+json_simple_string(TextView value)
+{
+  if (value.size() < 2 || value.front() != '"' || value.find('\\') != TextView::npos) {
+    return {};
+  }
+  return value.substr(1, value.size() - 2);
+}
+
+/// @return The JSON integer @a value, or @a invalid if it is not an integer.
+intmax_t
+json_integer(TextView value, intmax_t invalid)
+{
+  TextView parsed;
+  auto n = swoc::svtoi(value, &parsed);
+  return value.empty() || parsed.size() != value.size() ? invalid : n;
+}
+
+/** Parse a JSON NumericDate.
+ *
+ * @param value Raw JSON value.
+ * @param[out] t The time, truncated to seconds.
+ * @return @c true if @a value is a number, @c false if not.
+ *
+ * A NumericDate can have a fractional part (RFC 7519 section 2), which is dropped.
+ */
+bool
+json_numeric_date(TextView value, time_t &t)
+{
+  auto integer = value;
+  if (auto idx = value.find('.'); idx != TextView::npos) {
+    auto fraction = value.substr(idx + 1);
+    if (fraction.empty() || fraction.end() != std::find_if_not(fraction.begin(), fraction.end(), &isdigit)) {
+      return false;
+    }
+    integer = value.prefix(idx);
+  }
+  TextView parsed;
+  auto n = swoc::svtoi(integer, &parsed);
+  if (integer.empty() || parsed.size() != integer.size()) {
+    return false;
+  }
+  t = n;
+  return true;
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------------------ */
+/** Base for comparisons that verify a signed token.
+ *
+ * Verification is expensive, therefore tokens that verify are remembered in a sharded LRU cache
+ * keyed by a SHA-256 digest of the token. The cache entry is valid until the token expires, or
+ * until the keys change. Failed verifications are not cached.
+ *
+ * The keys are text, usually from a text block so that a key file can be reloaded. Each
+ * non-empty line that does not start with '#' is a key, either a name and a secret separated by
+ * whitespace or just a secret. The keys are parsed only when the text changes.
+ */
+class Cmp_token_verify : public Comparison
+{
+  using self_type  = Cmp_token_verify; ///< Self reference type.
+  using super_type = Comparison;       ///< Parent type.
+public:
+  static const ValueMask TYPES; ///< Supported types.
+
+  static inline const std::string KEYS_TAG{"keys"};
+  static inline const std::string CACHE_TAG{"cache"};
+  static inline const std::string CACHE_TTL_TAG{"cache-ttl"};
+
+  static constexpr size_t DEFAULT_CACHE_SIZE = 10000; ///< Default maximum cached tokens.
+
+protected:
+  /// Parsed keys.
+  struct KeySet {
+    std::string _text;                                ///< Source text.
+    std::vector<std::pair<TextView, TextView>> _keys; ///< Name and secret, views of @a _text.
+    unsigned _generation;                             ///< Distinguish key sets in the cache.
+
+    explicit KeySet(TextView text);
+
+    /// @return The secret for @a name, or an empty view if not found.
+    TextView find(TextView name) const;
+
+    /// Generation source.
+    static inline std::atomic<unsigned> _generation_count{0};
+  };
+
+  /// Cache of verified tokens.
+  class TokenCache
+  {
+  public:
+    /// Construct with a limit of @a size entries.
+    explicit TokenCache(size_t size) : _lru(size) {}
+
+    /** Look up a token.
+     *
+     * @param key Token digest.
+     * @param generation Key set generation.
+     * @param now Current time.
+     * @param ctx Context, for a copy of the payload.
+     * @param[out] payload Cached payload.
+     * @return @c true if the token is cached and valid.
+     */
+    bool find(TextView key, unsigned generation, time_t now, Context &ctx, TextView &payload);
+
+    /// Cache a verified token.
+    void insert(TextView key, unsigned generation, time_t expiry, TextView payload);
+
+  protected:
+    struct Entry {
+      unsigned _generation; ///< Key set generation.
+      time_t _expiry;       ///< Entry is invalid at this time.
+      std::string _payload; ///< Token payload.
+    };
+
+    ShardedLRU<Entry> _lru; ///< Cached entries, keyed by token digest.
+  };
+
+  Expr _keys;                                     ///< Key text.
+  std::unique_ptr<TokenCache> _cache;             ///< Verified tokens, if enabled.
+  Clock::duration _ttl = std::chrono::minutes{5}; ///< Maximum time a token is cached.
+  mutable std::shared_mutex _key_mutex;           ///< Protects @a _key_set.
+  mutable std::shared_ptr<KeySet const> _key_set; ///< Most recently used keys.
+
+  Cmp_token_verify() = default;
+
+  /// Load the common keys.
+  Errata load_common(Config &cfg, YAML::Node const &cmp_node, TextView const &key, YAML::Node value_node);
+
+  /// @return The current key set.
+  std::shared_ptr<KeySet const> keys(Context &ctx) const;
+
+  /// @return SHA-256 digest of @a text.
+  static std::array<char, 32> digest(TextView text);
+
+  /** Compute an HMAC.
+   *
+   * @param md Hash algorithm.
+   * @param secret Key.
+   * @param text Signed text.
+   * @param[out] out Output, must be at least @c EVP_MAX_MD_SIZE bytes.
+   * @return Size of the HMAC, 0 on error.
+   */
+  static unsigned hmac(EVP_MD const *md, TextView secret, TextView text, unsigned char *out);
+};
+
+const ValueMask Cmp_token_verify::TYPES{MaskFor(STRING)};
+
+Cmp_token_verify::KeySet::KeySet(TextView text) : _text(text), _generation(++_generation_count)
+{
+  TextView src{_text};
+  while (src) {
+    auto line = src.take_prefix_at('\n').trim_if(&isspace);
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    auto name = line.take_prefix_if(&isspace);
+    line.ltrim_if(&isspace);
+    if (line.empty()) { // secret only.
+      _keys.emplace_back(TextView{}, name);
+    } else {
+      _keys.emplace_back(name, line);
+    }
+  }
+}
+
+TextView
+Cmp_token_verify::KeySet::find(TextView name) const
+{
+  for (auto const &[key_name, secret] : _keys) {
+    if (key_name == name) {
+      return secret;
+    }
+  }
+  return {};
+}
+
+bool
+Cmp_token_verify::TokenCache::find(TextView key, unsigned generation, time_t now, Context &ctx, TextView &payload)
+{
+  return _lru.find(key, [&](Entry const &entry) -> bool {
+    if (entry._generation != generation || entry._expiry <= now) { // stale, drop it.
+      return false;
+    }
+    auto span = ctx.alloc_span<char>(entry._payload.size());
+    memcpy(span.data(), entry._payload.data(), span.size());
+    payload.assign(span.data(), span.size());
+    return true;
+  });
+}
+
+void
+Cmp_token_verify::TokenCache::insert(TextView key, unsigned generation, time_t expiry, TextView payload)
+{
+  _lru.insert(key, Entry{generation, expiry, std::string{payload}});
+}
+
+auto
+Cmp_token_verify::keys(Context &ctx) const -> std::shared_ptr<KeySet const>
+{
+  TextView text = ctx.extract_view(_keys);
+  {
+    std::shared_lock lock(_key_mutex);
+    if (_key_set && _key_set->_text == text) {
+      return _key_set;
+    }
+  }
+  auto key_set = std::make_shared<KeySet const>(text);
+  std::unique_lock lock(_key_mutex);
+  _key_set = key_set;
+  return key_set;
+}
+
+std::array<char, 32>
+Cmp_token_verify::digest(TextView text)
+{
+  std::array<char, 32> zret;
+  unsigned n = zret.size();
+  EVP_Digest(text.data(), text.size(), reinterpret_cast<unsigned char *>(zret.data()), &n, EVP_sha256(), nullptr);
+  return zret;
+}
+
+unsigned
+Cmp_token_verify::hmac(EVP_MD const *md, TextView secret, TextView text, unsigned char *out)
+{
+  unsigned n = 0;
+  if (nullptr == HMAC(md, secret.data(), secret.size(), reinterpret_cast<unsigned char const *>(text.data()), text.size(), out, &n)) {
+    return 0;
+  }
+  return n;
+}
+
+Errata
+Cmp_token_verify::load_common(Config &cfg, YAML::Node const &cmp_node, TextView const &key, YAML::Node value_node)
+{
+  if (!value_node.IsMap()) {
+    return Errata(S_ERROR, R"(Value for "{}" comparison at {} must be a map.)", key, cmp_node.Mark());
+  }
+
+  auto keys_node = value_node[KEYS_TAG];
+  if (!keys_node) {
+    return Errata(S_ERROR, R"("{}" comparison at {} must have a "{}" key.)", key, cmp_node.Mark(), KEYS_TAG);
+  }
+  auto &&[keys_expr, keys_errata]{cfg.parse_expr(keys_node)};
+  if (!keys_errata.is_ok()) {
+    keys_errata.note(R"(While parsing "{}" key for "{}" comparison at {}.)", KEYS_TAG, key, cmp_node.Mark());
+    return std::move(keys_errata);
+  }
+  if (!keys_expr.result_type().can_satisfy(STRING)) {
+    return Errata(S_ERROR, R"("{}" value for "{}" comparison at {} must be a string.)", KEYS_TAG, key, cmp_node.Mark());
+  }
+  _keys = std::move(keys_expr);
+
+  size_t cache_size = DEFAULT_CACHE_SIZE;
+  if (auto cache_node = value_node[CACHE_TAG]; cache_node) {
+    auto &&[expr, errata]{cfg.parse_expr(cache_node)};
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+    if (!expr.is_literal()) {
+      return Errata(S_ERROR, R"("{}" value for "{}" comparison at {} must be a literal integer.)", CACHE_TAG, key, cmp_node.Mark());
+    }
+    auto &&[n, n_errata]{std::get<Expr::LITERAL>(expr._raw).as_integer(-1)};
+    if (!n_errata.is_ok() || n < 0) {
+      return Errata(S_ERROR, R"("{}" value for "{}" comparison at {} must be a non-negative integer.)", CACHE_TAG, key,
+                    cmp_node.Mark());
+    }
+    cache_size = n;
+  }
+  if (cache_size > 0) {
+    _cache = std::make_unique<TokenCache>(cache_size);
+  }
+
+  if (auto ttl_node = value_node[CACHE_TTL_TAG]; ttl_node) {
+    auto &&[expr, errata]{cfg.parse_expr(ttl_node)};
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+    if (!expr.is_literal()) {
+      return Errata(S_ERROR, R"("{}" value for "{}" comparison at {} must be a literal duration.)", CACHE_TTL_TAG, key,
+                    cmp_node.Mark());
+    }
+    auto &&[ttl, ttl_errata]{std::get<Expr::LITERAL>(expr._raw).as_duration()};
+    if (!ttl_errata.is_ok()) {
+      return Errata(S_ERROR, R"("{}" value for "{}" comparison at {} is not a valid duration.)", CACHE_TTL_TAG, key,
+                    cmp_node.Mark());
+    }
+    _ttl = ttl;
+  }
+  return {};
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Verify a JSON Web Token.
+ *
+ * The active feature is the token, optionally prefixed by "Bearer ". The comparison matches if
+ * the signature is valid and the token is within its "nbf" and "exp" times. On a match the
+ * payload is available to the @c jwt-claim extractor for the rest of the transaction.
+ */
+class Cmp_jwt_verify : public Cmp_token_verify
+{
+  using self_type  = Cmp_jwt_verify;   ///< Self reference type.
+  using super_type = Cmp_token_verify; ///< Parent type.
+public:
+  static inline const std::string KEY{"jwt-verify"}; ///< Comparison name.
+
+  bool operator()(Context &ctx, feature_type_for<STRING> const &text) const override;
+
+  /// Construct an instance from YAML configuration.
+  static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
+
+protected:
+  ReservedSpan _ctx_span; ///< Context storage for the payload.
+
+  Cmp_jwt_verify() = default;
+
+  /// Verify @a token, @return The payload if valid, an empty view if not.
+  TextView verify(Context &ctx, KeySet const &keys, TextView token, time_t now, time_t &expiry) const;
+
+  /// @return The hash for JWT algorithm @a alg, or @c nullptr if not supported.
+  static EVP_MD const *md_for(TextView alg);
+};
+
+EVP_MD const *
+Cmp_jwt_verify::md_for(TextView alg)
+{
+  if (alg == "HS256"_tv) {
+    return EVP_sha256();
+  } else if (alg == "HS384"_tv) {
+    return EVP_sha384();
+  } else if (alg == "HS512"_tv) {
+    return EVP_sha512();
+  }
+  return nullptr; // In particular, "none" is never valid.
+}
+
+TextView
+Cmp_jwt_verify::verify(Context &ctx, KeySet const &keys, TextView token, time_t now, time_t &expiry) const
+{
+  TextView src      = token;
+  auto header_text  = src.take_prefix_at('.');
+  auto payload_text = src.take_prefix_at('.');
+  auto sig_text     = src;
+  if (header_text.empty() || payload_text.empty() || sig_text.empty() || sig_text.find('.') != TextView::npos) {
+    return {};
+  }
+  TextView signed_text{token.data(), sig_text.data() - 1};
+
+  auto buff = ctx.alloc_span<char>(token.size()); // large enough for all decoded parts.
+  auto n    = base64_decode(buff, header_text);
+  if (n < 0) {
+    return {};
+  }
+  TextView header{buff.data(), size_t(n)};
+  buff = buff.subspan(n, buff.size() - n);
+
+  n = base64_decode(buff, payload_text);
+  if (n < 0) {
+    return {};
+  }
+  TextView payload{buff.data(), size_t(n)};
+  buff = buff.subspan(n, buff.size() - n);
+
+  n = base64_decode(buff, sig_text);
+  if (n < 0) {
+    return {};
+  }
+  TextView sig{buff.data(), size_t(n)};
+
+  auto md = md_for(json_simple_string(json_member(header, "alg"_tv)));
+  if (md == nullptr) {
+    return {};
+  }
+
+  // Time checks first - they're much cheaper than the signature. A time claim that is present but
+  // not a number fails, it must not be treated as absent.
+  if (auto nbf_value = json_member(payload, "nbf"_tv); !nbf_value.empty()) {
+    time_t nbf;
+    if (!json_numeric_date(nbf_value, nbf) || nbf > now) {
+      return {};
+    }
+  }
+  expiry = std::numeric_limits<time_t>::max();
+  if (auto exp_value = json_member(payload, "exp"_tv); !exp_value.empty()) {
+    if (!json_numeric_date(exp_value, expiry)) {
+      return {};
+    }
+  }
+  if (expiry <= now) {
+    return {};
+  }
+
+  unsigned char mac[EVP_MAX_MD_SIZE];
+  auto check = [&](TextView secret) -> bool {
+    auto mac_size = hmac(md, secret, signed_text, mac);
+    return mac_size > 0 && mac_size == sig.size() && 0 == CRYPTO_memcmp(mac, sig.data(), mac_size);
+  };
+
+  if (auto kid = json_member(header, "kid"_tv); !kid.empty()) {
+    auto secret = keys.find(json_simple_string(kid));
+    return !secret.empty() && check(secret) ? payload : TextView{};
+  }
+  for (auto const &[name, secret] : keys._keys) {
+    if (check(secret)) {
+      return payload;
+    }
+  }
+  return {};
+}
+
+bool
+Cmp_jwt_verify::operator()(Context &ctx, feature_type_for<STRING> const &text) const
+{
+  TextView token = text;
+  token.trim_if(&isspace);
+  if (token.starts_with_nocase("Bearer "_tv)) {
+    token.remove_prefix(7);
+    token.ltrim_if(&isspace);
+  }
+  if (token.empty()) {
+    return false;
+  }
+
+  auto keys = this->keys(ctx);
+  time_t now = Clock::to_time_t(Clock::now());
+  TextView payload;
+  std::array<char, 32> key;
+
+  if (_cache) {
+    key = digest(token);
+    if (_cache->find(TextView{key.data(), key.size()}, keys->_generation, now, ctx, payload)) {
+      ctx.initialized_storage_for<TextView>(_ctx_span)[0] = payload;
+      return true;
+    }
+  }
+
+  time_t expiry = 0;
+  payload       = this->verify(ctx, *keys, token, now, expiry);
+  if (payload.empty()) {
+    return false;
+  }
+
+  if (_cache) {
+    auto limit = Clock::to_time_t(Clock::now() + _ttl);
+    _cache->insert(TextView{key.data(), key.size()}, keys->_generation, std::min(expiry, limit), payload);
+  }
+  ctx.initialized_storage_for<TextView>(_ctx_span)[0] = payload;
+  return true;
+}
+
+Rv<Comparison::Handle>
+Cmp_jwt_verify::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &, YAML::Node value_node)
+{
+  auto self = new (cfg) self_type;
+  Handle handle(self);
+  if (auto errata = self->load_common(cfg, cmp_node, key, value_node); !errata.is_ok()) {
+    return std::move(errata);
+  }
+  // Shared with the claim extractor, which finds it by name.
+  auto span = cfg.obtain_named_object<ReservedSpan>(JWT_CTX_KEY);
+  if (span->n == 0) {
+    *span = cfg.reserve_ctx_storage(sizeof(TextView));
+  }
+  self->_ctx_span = *span;
+  return handle;
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Verify a signed URL.
+ *
+ * The active feature is the URL. The signature must be the last query parameter, "S", and is the
+ * hex encoded HMAC of the URL up to and including "S=". The query must also contain the
+ * expiration time "E" in epoch seconds and the key name "K".
+ */
+class Cmp_url_sig_verify : public Cmp_token_verify
+{
+  using self_type  = Cmp_url_sig_verify; ///< Self reference type.
+  using super_type = Cmp_token_verify;   ///< Parent type.
+public:
+  static inline const std::string KEY{"url-sig-verify"}; ///< Comparison name.
+
+  static inline const std::string ALGORITHM_TAG{"algorithm"};
+
+  bool operator()(Context &ctx, feature_type_for<STRING> const &text) const override;
+
+  /// Construct an instance from YAML configuration.
+  static Rv<Handle> load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &arg, YAML::Node value_node);
+
+protected:
+  EVP_MD const *_md = EVP_sha256(); ///< Signature hash.
+
+  Cmp_url_sig_verify() = default;
+
+  /// Verify @a url, @return @c true if valid.
+  bool verify(KeySet const &keys, TextView url, time_t now, time_t &expiry) const;
+};
+
+bool
+Cmp_url_sig_verify::verify(KeySet const &keys, TextView url, time_t now, time_t &expiry) const
+{
+  auto query = url;
+  if (query.take_prefix_at('?').size() == url.size()) {
+    return false; // no query.
+  }
+  query = query.take_prefix_at('#');
+
+  TextView sig_hex, key_name;
+  TextView signed_text;
+  expiry = 0;
+  while (query) {
+    auto param = query.take_prefix_at('&');
+    auto name  = param.take_prefix_at('=');
+    if (name == "E"_tv) {
+      expiry = json_integer(param, 0);
+    } else if (name == "K"_tv) {
+      key_name = param;
+    } else if (name == "S"_tv) {
+      if (query) {
+        return false; // signature must be last.
+      }
+      sig_hex     = param;
+      signed_text = TextView{url.data(), param.data()};
+    }
+  }
+  if (sig_hex.empty() || key_name.empty() || expiry <= now) {
+    return false;
+  }
+
+  auto secret = keys.find(key_name);
+  if (secret.empty()) {
+    return false;
+  }
+
+  unsigned char mac[EVP_MAX_MD_SIZE];
+  auto mac_size = hmac(_md, secret, signed_text, mac);
+  if (mac_size == 0 || sig_hex.size() != 2 * mac_size) {
+    return false;
+  }
+  // Decode and compare every byte, to not leak the position of a mismatch.
+  unsigned char sig[EVP_MAX_MD_SIZE];
+  bool valid_p = true;
+  auto nibble = [&](char c) -> unsigned {
+    if (isdigit(c)) {
+      return c - '0';
+    } else if ('a' <= c && c <= 'f') {
+      return c - 'a' + 10;
+    } else if ('A' <= c && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    valid_p = false;
+    return 0;
+  };
+  for (unsigned idx = 0; idx < mac_size; ++idx) {
+    sig[idx] = (nibble(sig_hex[2 * idx]) << 4) | nibble(sig_hex[2 * idx + 1]);
+  }
+  return valid_p && 0 == CRYPTO_memcmp(mac, sig, mac_size);
+}
+
+bool
+Cmp_url_sig_verify::operator()(Context &ctx, feature_type_for<STRING> const &url) const
+{
+  if (url.empty()) {
+    return false;
+  }
+
+  auto keys  = this->keys(ctx);
+  time_t now = Clock::to_time_t(Clock::now());
+  TextView payload;
+  std::array<char, 32> key;
+
+  if (_cache) {
+    key = digest(url);
+    if (_cache->find(TextView{key.data(), key.size()}, keys->_generation, now, ctx, payload)) {
+      return true;
+    }
+  }
+
+  time_t expiry = 0;
+  if (!this->verify(*keys, url, now, expiry)) {
+    return false;
+  }
+  if (_cache) {
+    auto limit = Clock::to_time_t(Clock::now() + _ttl);
+    _cache->insert(TextView{key.data(), key.size()}, keys->_generation, std::min(expiry, limit), TextView{});
+  }
+  return true;
+}
+
+Rv<Comparison::Handle>
+Cmp_url_sig_verify::load(Config &cfg, YAML::Node const &cmp_node, TextView const &key, TextView const &, YAML::Node value_node)
+{
+  auto self = new (cfg) self_type;
+  Handle handle(self);
+  if (auto errata = self->load_common(cfg, cmp_node, key, value_node); !errata.is_ok()) {
+    return std::move(errata);
+  }
+  if (auto alg_node = value_node[ALGORITHM_TAG]; alg_node) {
+    TextView alg{alg_node.Scalar()};
+    if (0 == strcasecmp(alg, "sha256"_tv)) {
+      self->_md = EVP_sha256();
+    } else if (0 == strcasecmp(alg, "sha512"_tv)) {
+      self->_md = EVP_sha512();
+    } else if (0 == strcasecmp(alg, "sha1"_tv)) {
+      self->_md = EVP_sha1();
+    } else {
+      return Errata(S_ERROR, R"("{}" value "{}" for "{}" comparison at {} must be one of "sha256", "sha512", or "sha1".)",
+                    ALGORITHM_TAG, alg, KEY, cmp_node.Mark());
+    }
+  }
+  return handle;
+}
+
+/* ------------------------------------------------------------------------------------ */
+/** Extract a claim from the payload of the JWT verified by @c jwt-verify.
+ *
+ * Strings, integers, and booleans are extracted as those types, other values as their JSON text.
+ * The result is @c NIL if no token has been verified or the claim is not present.
+ */
+class Ex_jwt_claim : public Extractor
+{
+  using self_type  = Ex_jwt_claim; ///< Self reference type.
+  using super_type = Extractor;    ///< Parent type.
+public:
+  static constexpr TextView NAME{"jwt-claim"};
+
+  Rv<ActiveType> validate(Config &cfg, Spec &spec, TextView const &arg) override;
+
+  Feature extract(Context &ctx, Spec const &spec) override;
+  BufferWriter &format(BufferWriter &w, Spec const &spec, Context &ctx) override;
+
+protected:
+  /// Configuration data for the extractor.
+  struct Info {
+    ReservedSpan _span; ///< Payload storage.
+    TextView _name;     ///< Claim name.
+  };
+};
+
+Rv<ActiveType>
+Ex_jwt_claim::validate(Config &cfg, Spec &spec, const TextView &arg)
+{
+  if (arg.empty()) {
+    return Errata(S_ERROR, R"("{}" extractor requires an argument to specify the claim.)", NAME);
+  }
+  auto span = cfg.named_object<ReservedSpan>(JWT_CTX_KEY);
+  if (span == nullptr) {
+    return Errata(S_ERROR, R"("{}" extractor requires a previous "{}" comparison.)", NAME, Cmp_jwt_verify::KEY);
+  }
+  auto info       = cfg.alloc_span<Info>(1);
+  info[0]._span   = *span;
+  info[0]._name   = cfg.localize(TextView{arg});
+  spec._data.span = info.rebind<void>();
+  return ActiveType{NIL, STRING, INTEGER, BOOLEAN};
+}
+
+Feature
+Ex_jwt_claim::extract(Context &ctx, const Spec &spec)
+{
+  auto const &info = spec._data.span.rebind<Info>()[0];
+  auto payload     = ctx.initialized_storage_for<TextView>(info._span)[0];
+  auto value       = json_member(payload, info._name);
+  if (value.empty() || value == "null"_tv) {
+    return NIL_FEATURE;
+  }
+  if (value == "true"_tv) {
+    return feature_type_for<BOOLEAN>(true);
+  } else if (value == "false"_tv) {
+    return feature_type_for<BOOLEAN>(false);
+  } else if (value.front() == '"') {
+    if (auto text = json_simple_string(value); text.data() != nullptr) {
+      return FeatureView::Literal(text); // payload is in context memory.
+    }
+    // Unescape, leaving @c \u escapes as is.
+    return ctx.render_transient([&](BufferWriter &w) {
+      TextView text = value.substr(1, value.size() - 2);
+      while (text) {
+        char c = text.front();
+        text.remove_prefix(1);
+        if (c == '\\' && text) {
+          c = text.front();
+          text.remove_prefix(1);
+          switch (c) {
+          case 'n':
+            c = '\n';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'r':
+            c = '\r';
+            break;
+          case 'b':
+            c = '\b';
+            break;
+          case 'f':
+            c = '\f';
+            break;
+          case 'u':
+            w.write('\\');
+            break;
+          default:
+            break;
+          }
+        }
+        w.write(c);
+      }
+    });
+  } else if (auto n = json_integer(value, std::numeric_limits<intmax_t>::min()); n != std::numeric_limits<intmax_t>::min()) {
+    return feature_type_for<INTEGER>(n);
+  }
+  return FeatureView::Literal(value);
+}
+
+BufferWriter &
+Ex_jwt_claim::format(BufferWriter &w, Spec const &spec, Context &ctx)
+{
+  return bwformat(w, spec, this->extract(ctx, spec));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+namespace
+{
+Ex_jwt_claim jwt_claim;
+
+[[maybe_unused]] bool INITIALIZED = []() -> bool {
+  Comparison::define(Cmp_jwt_verify::KEY, Cmp_jwt_verify::TYPES, Cmp_jwt_verify::load);
+  Comparison::define(Cmp_url_sig_verify::KEY, Cmp_url_sig_verify::TYPES, Cmp_url_sig_verify::load);
+  Extractor::define(Ex_jwt_claim::NAME, &jwt_claim);
+  return true;
+}();
+} // namespace
@@ -677,6 +677,18 @@ ts::HttpTxn::set_upstream_addr(const swoc::IPAddr &addr) const
   return TS_SUCCESS == TSHttpTxnServerAddrSet(_txn, (swoc::IPEndpoint(addr)));
 }
 
+bool
+ts::HttpTxn::set_upstream_addr(const swoc::IPEndpoint &addr) const
+{
+  return TS_SUCCESS == TSHttpTxnServerAddrSet(_txn, &addr.sa);
+}
+
+TSServerState
+ts::HttpTxn::upstream_state() const
+{
+  return TSHttpTxnServerStateGet(_txn);
+}
+
 swoc::MemSpan<char>
 ts::HttpTxn::ts_dup(swoc::TextView const &text)
 {
@@ -933,7 +945,7 @@ HttpTxn::init(swoc::Errata &errata)
 
 // ----
 
-int
+intmax_t
 plugin_stat_value(int idx)
 {
   return TSStatIntGet(idx);
@@ -972,6 +984,26 @@ plugin_stat_update(int idx, intmax_t value)
   TSStatIntIncrement(idx, value);
 }
 
+void
+plugin_stat_set(int idx, intmax_t value)
+{
+  TSStatIntSet(idx, value);
+}
+
+void
+plugin_stat_dump(std::function<void(TextView name, intmax_t value)> const &f)
+{
+  using F = std::function<void(TextView, intmax_t)>;
+  TSRecordDump(
+    TS_RECORDTYPE_PLUGIN,
+    [](TSRecordType, void *edata, int, const char *name, TSRecordDataType type, TSRecordData *datum) -> void {
+      if (type == TS_RECORDDATATYPE_INT) {
+        (*static_cast<F const *>(edata))(TextView{name, strlen(name)}, datum->rec_int);
+      }
+    },
+    const_cast<F *>(&f));
+}
+
 // ----
 void
 TaskHandle::cancel()
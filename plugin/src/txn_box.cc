@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: Apache-2.0
 */
 
+#include <array>
 #include <string>
 #include <map>
 #include <numeric>
@@ -61,6 +62,66 @@ scoped_plugin_config()
   return Plugin_Config;
 }
 
+/// Memory statistic name prefix for the active configuration.
+constexpr TextView CFG_MEMORY_STAT_PREFIX = "plugin.txn_box.memory.cfg.";
+/// Memory statistic names for the active configuration.
+const std::array<TextView, 8> Cfg_Memory_Stat_Name{"arena.allocated", "arena.reserved", "directive.count", "rxp.count",
+                                                   "rxp.bytes",       "text.count",     "text.bytes",      "text.stored"};
+/// Memory statistic indices for the active configuration, negative if not defined.
+std::array<int, Cfg_Memory_Stat_Name.size()> Cfg_Memory_Stat_Idx{-1, -1, -1, -1, -1, -1, -1, -1};
+
+/// @return The memory statistic values for @a cfg, in the same order as @c Cfg_Memory_Stat_Name.
+std::array<size_t, Cfg_Memory_Stat_Name.size()>
+cfg_memory_values(Config const &cfg)
+{
+  auto info = cfg.memory_info();
+  return {info._arena_allocated, info._arena_reserved, info._directive_count, info._rxp_count,
+          info._rxp_bytes,       info._text_count,     info._text_bytes,      info._text_stored};
+}
+
+Errata
+cfg_memory_stats_define()
+{
+  std::string name;
+  for (unsigned idx = 0; idx < Cfg_Memory_Stat_Name.size(); ++idx) {
+    swoc::bwprint(name, "{}{}", CFG_MEMORY_STAT_PREFIX, Cfg_Memory_Stat_Name[idx]);
+    auto &&[stat_idx, errata]{ts::plugin_stat_define(name, 0, false)};
+    if (!errata.is_ok()) {
+      return std::move(errata);
+    }
+    Cfg_Memory_Stat_Idx[idx] = stat_idx;
+  }
+  return {};
+}
+
+/// Update the memory statistics for a newly active configuration @a cfg.
+void
+cfg_memory_stats_update(Config const &cfg)
+{
+  auto values = cfg_memory_values(cfg);
+  for (unsigned idx = 0; idx < values.size(); ++idx) {
+    if (Cfg_Memory_Stat_Idx[idx] >= 0) {
+      ts::plugin_stat_set(Cfg_Memory_Stat_Idx[idx], values[idx]);
+    }
+  }
+}
+
+/// Log the memory use of the active configuration and of transaction contexts.
+void
+memory_report()
+{
+  swoc::LocalBufferWriter<4096> w;
+  w.print("{}: memory use\n", Config::PLUGIN_NAME);
+  if (auto cfg = scoped_plugin_config(); cfg) {
+    auto values = cfg_memory_values(*cfg);
+    for (unsigned idx = 0; idx < values.size(); ++idx) {
+      w.print("{}{} {}\n", CFG_MEMORY_STAT_PREFIX, Cfg_Memory_Stat_Name[idx], values[idx]);
+    }
+  }
+  Context::memory_stats_print(w);
+  TSNote("%.*s", int(w.size()), w.data());
+}
+
 } // namespace
 /* ------------------------------------------------------------------------------------ */
 void
@@ -77,8 +138,9 @@ Global::reserve_txn_arg()
 }
 /* ------------------------------------------------------------------------------------ */
 // Global callback, thread safe.
-// This sets up local context for a transaction and spins up a per TXN Continuation which is
-// protected by a mutex. This hook isn't set if there are no top level directives.
+// This sets up local context for a transaction and adds the transaction hooks, which use a shared
+// continuation and find the context via the transaction argument. This hook isn't set if there are
+// no top level directives.
 int
 CB_Txn_Start(TSCont, TSEvent, void *payload)
 {
@@ -102,6 +164,9 @@ Task_ConfigReload()
     swoc::bwprint(err_str, "{}: Failed to reload configuration.\n{}", Config::PLUGIN_NAME, errata);
     TSError("%s", err_str.c_str());
   } else {
+    // Bind lazy resources before publication so the first transactions don't pay for it.
+    cfg->warm_up();
+    cfg_memory_stats_update(*cfg);
     std::unique_lock lock(Plugin_Config_Mutex);
     Plugin_Config = cfg;
   }
@@ -119,6 +184,7 @@ CB_TxnBoxMsg(TSCont, TSEvent, void *data)
 {
   static constexpr TextView TAG{"txn_box."};
   static constexpr TextView RELOAD("reload");
+  static constexpr TextView MEMORY("memory");
   auto msg = static_cast<TSPluginMsg *>(data);
   if (TextView tag{msg->tag, strlen(msg->tag)}; tag.starts_with_nocase(TAG)) {
     tag.remove_prefix(TAG.size());
@@ -131,6 +197,8 @@ CB_TxnBoxMsg(TSCont, TSEvent, void *data)
         swoc::bwprint(err_str, "{}: Reload requested while previous reload still active", Config::PLUGIN_NAME);
         TSError("%s", err_str.c_str());
       }
+    } else if (0 == strcasecmp(tag, MEMORY)) {
+      memory_report();
     }
   }
   return TS_SUCCESS;
@@ -156,6 +224,7 @@ TxnBoxInit()
   if (!errata.is_ok()) {
     return errata;
   }
+  Plugin_Config->warm_up();
   auto delta = std::chrono::system_clock::now() - t0;
   std::string text;
   TSDebug(Config::PLUGIN_TAG.data(), "%s",
@@ -167,6 +236,17 @@ TxnBoxInit()
     TSCont cont{TSContCreate(CB_Txn_Start, nullptr)};
     TSHttpHookAdd(TS_HTTP_TXN_START_HOOK, cont);
     G.reserve_txn_arg();
+    // Memory accounting is diagnostic, failure to create the statistics is not fatal.
+    auto stat_errata = cfg_memory_stats_define();
+    if (stat_errata.is_ok()) {
+      cfg_memory_stats_update(*Plugin_Config);
+    }
+    stat_errata.note(Context::memory_stats_define());
+    if (!stat_errata.is_ok()) {
+      std::string err_str;
+      swoc::bwprint(err_str, "{}: memory statistics are not available.\n{}", Config::PLUGIN_NAME, stat_errata);
+      TSError("%s", err_str.c_str());
+    }
   } else {
     errata.note(R"({}: plugin registration failed.)", Config::PLUGIN_TAG);
     return errata;
@@ -93,6 +93,7 @@ TSRemapNewInstance(int argc, char *argv[], void **ih, char *errbuff, int errbuff
     return TS_ERROR;
   }
 
+  cfg->warm_up();
   G._remap_ctx_storage_required += cfg->reserved_ctx_storage_size();
   *ih = new RemapContext{cfg};
   return TS_SUCCESS;
@@ -0,0 +1,485 @@
+/** @file
+   Upstream pool directives.
+
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "txn_box/common.h"
+
+#include <swoc/TextView.h>
+#include <swoc/Errata.h>
+#include <swoc/Lexicon.h>
+#include <swoc/swoc_ip.h>
+
+#include "txn_box/Directive.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+
+#include "txn_box/yaml_util.h"
+#include "txn_box/ts_util.h"
+
+using swoc::TextView;
+using swoc::Errata;
+using swoc::Rv;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+/** Define a pool of upstreams.
+ *
+ * Each member has passive health tracking. When a transaction that used a member closes, the
+ * upstream response status and connection state are checked. A member with too many consecutive
+ * failures is put in to a cooldown and is not selected until the cooldown expires, unless every
+ * member is in cooldown. All member state is atomic, selection and updates do not lock.
+ */
+class Do_upstream_pool_define : public Directive
+{
+  using self_type  = Do_upstream_pool_define; ///< Self reference type.
+  using super_type = Directive;               ///< Parent type.
+protected:
+  struct CfgInfo;
+
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static inline const std::string KEY{"upstream-pool-define"}; ///< Directive name.
+  static const HookMask HOOKS;                                 ///< Valid hooks for directive.
+
+  static constexpr Options OPTIONS{sizeof(CfgInfo *)};
+
+  /// Member selection policy.
+  enum class Policy {
+    INVALID,           ///< Invalid / not set.
+    WEIGHTED_RANDOM,   ///< Random, proportional to weight.
+    LEAST_OUTSTANDING, ///< Fewest in flight transactions relative to weight.
+  };
+
+  /// A pool member.
+  struct Member {
+    swoc::IPEndpoint _addr;                  ///< Upstream address.
+    unsigned _weight = 1;                    ///< Selection weight.
+    unsigned _cumulative_weight = 0;         ///< Sum of weights up to and including this member.
+    std::atomic<int> _outstanding{0};        ///< Transactions in flight.
+    std::atomic<unsigned> _fails{0};         ///< Consecutive failures.
+    std::atomic<Clock::rep> _down_until{0};  ///< End of cooldown.
+
+    /// @return @c true if the member is not in cooldown at time @a now.
+    bool
+    is_up(Clock::rep now) const
+    {
+      return _down_until.load(std::memory_order_relaxed) <= now;
+    }
+  };
+
+  /** Transaction use of a member.
+   * This is created in the transaction context and destroyed when the context is destroyed,
+   * at which point the member is released and its health updated.
+   */
+  struct Selection {
+    self_type *_pool = nullptr; ///< Pool.
+    Member *_member  = nullptr; ///< Selected member.
+    TSHttpTxn _txn   = nullptr; ///< Transaction.
+
+    ~Selection();
+  };
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+  /** Create config level shared data.
+   *
+   * @param cfg Configuration.
+   * @param rtti Static configuration data
+   * @return
+   */
+  static Errata cfg_init(Config &cfg, CfgStaticData const *rtti);
+
+  /** Find a pool by name.
+   *
+   * @param cfg Configuration.
+   * @param name Name of the pool.
+   * @return The pool, or @c nullptr if not found.
+   */
+  static self_type *find(Config &cfg, TextView const &name);
+
+  /** Select a member.
+   *
+   * @return The selected member.
+   *
+   * The outstanding count of the member is incremented.
+   */
+  Member &select();
+
+  /** Release a member.
+   *
+   * @param member Member to release.
+   * @param txn Transaction that used @a member.
+   */
+  void release(Member &member, ts::HttpTxn txn);
+
+protected:
+  using Map = std::unordered_map<TextView, self_type *, std::hash<std::string_view>>;
+
+  /// Config level data for all pools.
+  struct CfgInfo {
+    Map _map; ///< Map of names to pools.
+  };
+
+  TextView _name;                       ///< Pool name.
+  Policy _policy = Policy::WEIGHTED_RANDOM; ///< Selection policy.
+  std::unique_ptr<Member[]> _members;   ///< Members.
+  unsigned _count        = 0;           ///< Number of members.
+  unsigned _total_weight = 0;           ///< Sum of member weights.
+  unsigned _max_fails    = 3;           ///< Consecutive failures for cooldown.
+  Clock::duration _cooldown = std::chrono::seconds(10); ///< Cooldown duration.
+  int _line_no = 0;                     ///< For debugging name conflicts.
+
+  static thread_local std::minstd_rand _engine; ///< Random number generator.
+
+  static inline const std::string NAME_TAG{"name"};
+  static inline const std::string MEMBERS_TAG{"members"};
+  static inline const std::string ADDR_TAG{"addr"};
+  static inline const std::string WEIGHT_TAG{"weight"};
+  static inline const std::string POLICY_TAG{"policy"};
+  static inline const std::string FAILURES_TAG{"failures"};
+  static inline const std::string COOLDOWN_TAG{"cooldown"};
+
+  static const swoc::Lexicon<Policy> PolicyNames;
+
+  Do_upstream_pool_define() = default;
+
+  /// Current time in the cooldown time base.
+  static Clock::rep
+  now()
+  {
+    return Clock::now().time_since_epoch().count();
+  }
+
+  /** Load a member.
+   *
+   * @param node Member node.
+   * @param member [out] Member to load.
+   * @return Errors, if any.
+   */
+  static Errata load_member(YAML::Node const &node, Member &member);
+};
+
+// Remap is allowed so that a remap configuration can define its own pools.
+const HookMask Do_upstream_pool_define::HOOKS{MaskFor({Hook::POST_LOAD, Hook::REMAP})};
+
+const swoc::Lexicon<Do_upstream_pool_define::Policy> Do_upstream_pool_define::PolicyNames{
+  {{Policy::WEIGHTED_RANDOM, "weighted-random"}, {Policy::LEAST_OUTSTANDING, "least-outstanding"}}, Policy::INVALID};
+
+thread_local std::minstd_rand Do_upstream_pool_define::_engine(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+Do_upstream_pool_define::Selection::~Selection()
+{
+  _pool->release(*_member, _txn);
+}
+
+auto
+Do_upstream_pool_define::find(Config &cfg, TextView const &name) -> self_type *
+{
+  if (auto rtti = cfg.drtv_info(KEY); rtti && rtti->_count > 0) {
+    auto &map = rtti->_cfg_store.rebind<CfgInfo *>()[0]->_map;
+    if (auto spot = map.find(name); spot != map.end()) {
+      return spot->second;
+    }
+  }
+  return nullptr;
+}
+
+auto
+Do_upstream_pool_define::select() -> Member &
+{
+  auto t       = now();
+  Member *zret = nullptr;
+
+  if (Policy::LEAST_OUTSTANDING == _policy) {
+    // Start at a random member so ties are spread out.
+    unsigned start = _engine() % _count;
+    for (unsigned n = 0; n < _count; ++n) {
+      auto &m = _members[(start + n) % _count];
+      if (!m.is_up(t)) {
+        continue;
+      }
+      // Compare outstanding / weight without division.
+      if (nullptr == zret || uint64_t(m._outstanding.load(std::memory_order_relaxed)) * zret->_weight <
+                               uint64_t(zret->_outstanding.load(std::memory_order_relaxed)) * m._weight) {
+        zret = &m;
+      }
+    }
+  } else {
+    unsigned r = _engine() % _total_weight;
+    auto spot  = std::upper_bound(&_members[0], &_members[_count], r,
+                                  [](unsigned r, Member const &m) -> bool { return r < m._cumulative_weight; });
+    unsigned idx = spot - &_members[0];
+    // If that's in cooldown, take the next member that isn't.
+    for (unsigned n = 0; n < _count; ++n) {
+      if (auto &m = _members[(idx + n) % _count]; m.is_up(t)) {
+        zret = &m;
+        break;
+      }
+    }
+  }
+
+  if (nullptr == zret) { // Everything is in cooldown - fail open with a random member.
+    zret = &_members[_engine() % _count];
+  }
+  zret->_outstanding.fetch_add(1, std::memory_order_relaxed);
+  return *zret;
+}
+
+void
+Do_upstream_pool_define::release(Member &member, ts::HttpTxn txn)
+{
+  member._outstanding.fetch_sub(1, std::memory_order_relaxed);
+
+  bool failed_p = false;
+  switch (txn.upstream_state()) {
+  case TS_SRVSTATE_CONNECTION_ERROR:
+  case TS_SRVSTATE_ACTIVE_TIMEOUT:
+  case TS_SRVSTATE_INACTIVE_TIMEOUT:
+    failed_p = true;
+    break;
+  default:
+    if (auto ursp{txn.ursp_hdr()}; ursp.is_valid()) {
+      failed_p = ursp.status() >= 500;
+    } else {
+      return; // upstream was never contacted, no health information.
+    }
+    break;
+  }
+
+  if (failed_p) {
+    if (member._fails.fetch_add(1, std::memory_order_relaxed) + 1 >= _max_fails) {
+      member._fails.store(0, std::memory_order_relaxed);
+      member._down_until.store(now() + _cooldown.count(), std::memory_order_relaxed);
+    }
+  } else {
+    member._fails.store(0, std::memory_order_relaxed);
+  }
+}
+
+Errata
+Do_upstream_pool_define::invoke(Context &)
+{
+  return {};
+}
+
+Errata
+Do_upstream_pool_define::load_member(YAML::Node const &node, Member &member)
+{
+  YAML::Node addr_node = node;
+  if (node.IsMap()) {
+    addr_node = node[ADDR_TAG];
+    if (!addr_node) {
+      return Errata(S_ERROR, R"(Member at {} must have a "{}" key.)", node.Mark(), ADDR_TAG);
+    }
+    if (auto weight_node = node[WEIGHT_TAG]; weight_node) {
+      TextView src{weight_node.Scalar()}, parsed;
+      src.trim_if(&isspace);
+      member._weight = swoc::svtou(src, &parsed);
+      if (src.empty() || src.size() != parsed.size() || member._weight == 0) {
+        return Errata(S_ERROR, R"("{}" value "{}" at {} is not a positive integer as required.)", WEIGHT_TAG, src,
+                      weight_node.Mark());
+      }
+    }
+  }
+  if (!addr_node.IsScalar() || !member._addr.parse(addr_node.Scalar())) {
+    return Errata(S_ERROR, R"(Member address at {} is not a valid IP address and port.)", addr_node.Mark());
+  }
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_upstream_pool_define::load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &,
+                              swoc::TextView const &, YAML::Node key_value)
+{
+  auto self = new (cfg) self_type();
+  Handle handle(self);
+  self->_line_no = drtv_node.Mark().line;
+
+  if (!key_value.IsMap()) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a map as its value.)", KEY, drtv_node.Mark());
+  }
+
+  auto name_node = key_value[NAME_TAG];
+  if (!name_node || !name_node.IsScalar() || name_node.Scalar().empty()) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key with a non-empty string value.)", KEY, drtv_node.Mark(),
+                  NAME_TAG);
+  }
+  self->_name = cfg.localize(TextView{name_node.Scalar()});
+
+  if (auto policy_node = key_value[POLICY_TAG]; policy_node) {
+    self->_policy = PolicyNames[TextView{policy_node.Scalar()}];
+    if (Policy::INVALID == self->_policy) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} must be "weighted-random" or "least-outstanding".)", POLICY_TAG,
+                    policy_node.Mark(), KEY, drtv_node.Mark());
+    }
+  }
+
+  if (auto fails_node = key_value[FAILURES_TAG]; fails_node) {
+    TextView src{fails_node.Scalar()}, parsed;
+    src.trim_if(&isspace);
+    self->_max_fails = swoc::svtou(src, &parsed);
+    if (src.empty() || src.size() != parsed.size() || self->_max_fails == 0) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} must be a positive integer.)", FAILURES_TAG,
+                    fails_node.Mark(), KEY, drtv_node.Mark());
+    }
+  }
+
+  if (auto cooldown_node = key_value[COOLDOWN_TAG]; cooldown_node) {
+    auto &&[dur_value, dur_errata]{Feature{cooldown_node.Scalar()}.as_duration()};
+    if (!dur_errata.is_ok()) {
+      return Errata(S_ERROR, R"("{}" value at {} for "{}" directive at {} is not a valid duration.)", COOLDOWN_TAG,
+                    cooldown_node.Mark(), KEY, drtv_node.Mark());
+    }
+    self->_cooldown = std::chrono::duration_cast<Clock::duration>(dur_value);
+  }
+
+  auto members_node = key_value[MEMBERS_TAG];
+  if (!members_node || !members_node.IsSequence() || members_node.size() == 0) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have a "{}" key with a non-empty list of members.)", KEY, drtv_node.Mark(),
+                  MEMBERS_TAG);
+  }
+  self->_count = members_node.size();
+  self->_members.reset(new Member[self->_count]);
+  unsigned idx = 0;
+  for (auto child : members_node) {
+    auto &member = self->_members[idx++];
+    if (auto errata = load_member(child, member); !errata.is_ok()) {
+      errata.note(R"(While parsing "{}" directive at {}.)", KEY, drtv_node.Mark());
+      return errata;
+    }
+    self->_total_weight      += member._weight;
+    member._cumulative_weight = self->_total_weight;
+  }
+
+  // Put the pool in the map.
+  auto &map = rtti->_cfg_store.rebind<CfgInfo *>()[0]->_map;
+  if (auto spot = map.find(self->_name); spot != map.end()) {
+    return Errata(S_ERROR, R"("{}" directive at {} has the same name "{}" as another instance at line {}.)", KEY, drtv_node.Mark(),
+                  self->_name, spot->second->_line_no);
+  }
+  map[self->_name] = self;
+
+  return handle;
+}
+
+Errata
+Do_upstream_pool_define::cfg_init(Config &cfg, CfgStaticData const *rtti)
+{
+  // Get space for instance.
+  auto cfg_info = cfg.allocate_cfg_storage(sizeof(CfgInfo), 8).rebind<CfgInfo>().data();
+  // Initialize it.
+  new (cfg_info) CfgInfo;
+  // Remember where it is.
+  rtti->_cfg_store.rebind<CfgInfo *>()[0] = cfg_info;
+  // Clean it up when the config is destroyed.
+  cfg.mark_for_cleanup(cfg_info);
+  return {};
+}
+
+/* ------------------------------------------------------------------------------------ */
+/// Set the upstream to a member of a pool.
+class Do_upstream_pool : public Directive
+{
+  using self_type  = Do_upstream_pool; ///< Self reference type.
+  using super_type = Directive;        ///< Parent type.
+public:
+  static inline const std::string KEY{"upstream-pool"}; ///< Directive name.
+  static const HookMask HOOKS;                          ///< Valid hooks for directive.
+
+  Errata invoke(Context &ctx) override; ///< Runtime activation.
+
+  /** Load from YAML node.
+   *
+   * @param cfg Configuration data.
+   * @param rtti Configuration level static data for this directive.
+   * @param drtv_node Node containing the directive.
+   * @param name Name from key node tag.
+   * @param arg Arg from key node tag.
+   * @param key_value Value for directive @a KEY
+   * @return A directive, or errors on failure.
+   */
+  static Rv<Handle> load(Config &cfg, CfgStaticData const *rtti, YAML::Node drtv_node, swoc::TextView const &name,
+                         swoc::TextView const &arg, YAML::Node key_value);
+
+protected:
+  TextView _name;                             ///< Pool name.
+  Do_upstream_pool_define *_pool = nullptr;   ///< Pool, if resolved during load.
+
+  Do_upstream_pool(TextView const &name, Do_upstream_pool_define *pool) : _name(name), _pool(pool) {}
+};
+
+const HookMask Do_upstream_pool::HOOKS{MaskFor({Hook::CREQ, Hook::PRE_REMAP, Hook::REMAP, Hook::POST_REMAP, Hook::PREQ})};
+
+Errata
+Do_upstream_pool::invoke(Context &ctx)
+{
+  auto pool = _pool;
+  if (nullptr == pool) { // remap configuration - find the pool in the global configuration.
+    if (auto cfg = ctx.acquire_cfg(); cfg) {
+      pool = Do_upstream_pool_define::find(*cfg, _name);
+    }
+    if (nullptr == pool) {
+      return Errata(S_ERROR, R"("{}" directive - pool "{}" is not defined.)", KEY, _name);
+    }
+  }
+
+  auto &member = pool->select();
+  ctx._txn.set_upstream_addr(member._addr);
+  // Release the member when the transaction is done.
+  auto selection = ctx.make<Do_upstream_pool_define::Selection>();
+  selection->_pool   = pool;
+  selection->_member = &member;
+  selection->_txn    = ctx._txn;
+  ctx.mark_for_cleanup(selection);
+  return {};
+}
+
+Rv<Directive::Handle>
+Do_upstream_pool::load(Config &cfg, CfgStaticData const *, YAML::Node drtv_node, swoc::TextView const &, swoc::TextView const &,
+                       YAML::Node key_value)
+{
+  if (!key_value.IsScalar() || key_value.Scalar().empty()) {
+    return Errata(S_ERROR, R"("{}" directive at {} must have the name of a pool as its value.)", KEY, drtv_node.Mark());
+  }
+  TextView name{key_value.Scalar()};
+  auto pool = Do_upstream_pool_define::find(cfg, name);
+  if (nullptr == pool && Hook::REMAP != cfg.current_hook()) {
+    return Errata(S_ERROR, R"("{}" directive at {} - "{}" is not the name of a defined pool.)", KEY, drtv_node.Mark(), name);
+  }
+  return Handle(new (cfg) self_type(cfg.localize(name), pool));
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+namespace
+{
+[[maybe_unused]] bool INITIALIZED = []() -> bool {
+  Config::define<Do_upstream_pool_define>();
+  Config::define<Do_upstream_pool>();
+  return true;
+}();
+} // namespace
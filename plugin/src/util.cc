@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <array>
+#include <cstring>
 #include <string>
 #include <chrono>
 
@@ -205,6 +207,236 @@ UnitParser<E>::operator()(swoc::TextView const &src) const noexcept -> Rv<value_
   return zret;
 }
 
+// ----
+BufferWriter &
+json_string(BufferWriter &w, TextView text)
+{
+  w.write('"');
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      w.write('\\').write(c);
+    } else if (c == '\n') {
+      w.write("\\n"_tv);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      w.print("\\u{:04x}", static_cast<unsigned>(c));
+    } else {
+      w.write(c);
+    }
+  }
+  return w.write('"');
+}
+
+namespace
+{
+/// Load 8 bytes little endian.
+inline uint64_t
+wy_r8(uint8_t const *p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+/// Load 4 bytes little endian.
+inline uint64_t
+wy_r4(uint8_t const *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+/// Load 1 to 3 bytes.
+inline uint64_t
+wy_r3(uint8_t const *p, size_t k)
+{
+  return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+/// 128 bit product of @a a and @a b, low half in @a a and high half in @a b.
+inline void
+wy_mum(uint64_t &a, uint64_t &b)
+{
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 r = a;
+  r *= b;
+  a = uint64_t(r);
+  b = uint64_t(r >> 64);
+#else
+  uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+  a = lo;
+  b = hi;
+#endif
+}
+
+inline uint64_t
+wy_mix(uint64_t a, uint64_t b)
+{
+  wy_mum(a, b);
+  return a ^ b;
+}
+
+constexpr uint64_t WY_SECRET[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+/// Base64 decoding table for both alphabets, 0xFF for invalid characters.
+constexpr std::array<uint8_t, 256> BASE64_VALUES = []() {
+  std::array<uint8_t, 256> zret{};
+  for (auto &v : zret) {
+    v = 0xFF;
+  }
+  for (unsigned i = 0; i < 26; ++i) {
+    zret['A' + i] = i;
+    zret['a' + i] = i + 26;
+  }
+  for (unsigned i = 0; i < 10; ++i) {
+    zret['0' + i] = i + 52;
+  }
+  zret['+'] = zret['-'] = 62;
+  zret['/'] = zret['_'] = 63;
+  return zret;
+}();
+
+constexpr char BASE64_CHARS[]     = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char BASE64_URL_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+} // namespace
+
+uint64_t
+Hash64Wy(TextView text, uint64_t seed)
+{
+  auto p     = reinterpret_cast<uint8_t const *>(text.data());
+  size_t len = text.size();
+  uint64_t a, b;
+
+  seed ^= wy_mix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (wy_r4(p) << 32) | wy_r4(p + ((len >> 3) << 2));
+      b = (wy_r4(p + len - 4) << 32) | wy_r4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = wy_r3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i >= 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = wy_mix(wy_r8(p) ^ WY_SECRET[1], wy_r8(p + 8) ^ seed);
+        see1 = wy_mix(wy_r8(p + 16) ^ WY_SECRET[2], wy_r8(p + 24) ^ see1);
+        see2 = wy_mix(wy_r8(p + 32) ^ WY_SECRET[3], wy_r8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i >= 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = wy_mix(wy_r8(p) ^ WY_SECRET[1], wy_r8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = wy_r8(p + i - 16);
+    b = wy_r8(p + i - 8);
+  }
+  a ^= WY_SECRET[1];
+  b ^= seed;
+  wy_mum(a, b);
+  return wy_mix(a ^ WY_SECRET[0] ^ len, b ^ WY_SECRET[1]);
+}
+
+size_t
+base64_encode(swoc::MemSpan<char> dst, TextView src, bool url_p)
+{
+  auto chars = url_p ? BASE64_URL_CHARS : BASE64_CHARS;
+  auto s     = reinterpret_cast<uint8_t const *>(src.data());
+  auto d     = dst.data();
+  size_t n   = src.size();
+
+  for (; n >= 3; n -= 3, s += 3) {
+    uint32_t v = (uint32_t(s[0]) << 16) | (uint32_t(s[1]) << 8) | s[2];
+    *d++       = chars[v >> 18];
+    *d++       = chars[(v >> 12) & 0x3F];
+    *d++       = chars[(v >> 6) & 0x3F];
+    *d++       = chars[v & 0x3F];
+  }
+  if (n > 0) {
+    uint32_t v = uint32_t(s[0]) << 16;
+    if (n > 1) {
+      v |= uint32_t(s[1]) << 8;
+    }
+    *d++ = chars[v >> 18];
+    *d++ = chars[(v >> 12) & 0x3F];
+    if (n > 1) {
+      *d++ = chars[(v >> 6) & 0x3F];
+    } else if (!url_p) {
+      *d++ = '=';
+    }
+    if (!url_p) {
+      *d++ = '=';
+    }
+  }
+  return d - dst.data();
+}
+
+ssize_t
+base64_decoded_size(TextView src)
+{
+  while (src.size() && src.back() == '=') {
+    src.remove_suffix(1);
+  }
+  if (src.size() % 4 == 1) {
+    return -1;
+  }
+  return (src.size() * 3) / 4;
+}
+
+ssize_t
+base64_decode(swoc::MemSpan<char> dst, TextView src)
+{
+  auto size = base64_decoded_size(src);
+  if (size < 0 || dst.size() < size_t(size)) {
+    return -1;
+  }
+  auto s   = reinterpret_cast<uint8_t const *>(src.data());
+  auto out = reinterpret_cast<uint8_t *>(dst.data());
+  size_t n = (size / 3) * 4; // characters in full groups.
+
+  // Four characters to three bytes per step, checking validity once per group.
+  for (auto limit = s + n; s < limit; s += 4) {
+    uint32_t v0 = BASE64_VALUES[s[0]], v1 = BASE64_VALUES[s[1]], v2 = BASE64_VALUES[s[2]], v3 = BASE64_VALUES[s[3]];
+    if ((v0 | v1 | v2 | v3) & 0x80) {
+      return -1;
+    }
+    uint32_t v = (v0 << 18) | (v1 << 12) | (v2 << 6) | v3;
+    *out++     = v >> 16;
+    *out++     = v >> 8;
+    *out++     = v;
+  }
+  if (auto tail = size % 3; tail > 0) {
+    uint32_t v0 = BASE64_VALUES[s[0]], v1 = BASE64_VALUES[s[1]], v2 = tail > 1 ? BASE64_VALUES[s[2]] : 0;
+    if ((v0 | v1 | v2) & 0x80) {
+      return -1;
+    }
+    uint32_t v = (v0 << 18) | (v1 << 12) | (v2 << 6);
+    *out++     = v >> 16;
+    if (tail > 1) {
+      *out++ = v >> 8;
+    }
+  }
+  return size;
+}
+
 // ----
 namespace
 {
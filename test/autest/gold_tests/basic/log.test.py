@@ -0,0 +1,77 @@
+# @file
+#
+# Copyright 2020, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+import os.path
+
+Test.Summary = '''
+Structured logging.
+'''
+
+class State:
+    Description = "Checking log records."
+
+    # Expected records for each log, without the timestamp.
+    records = {
+        "txn_box_kv" : [
+            'uuid=log-1 path=log/one band=Delain status=200'
+          , 'uuid=log-2 path=log/two band="Within Temptation" status=200'
+        ]
+      , "txn_box_json" : [
+            '{"uuid":"log-1","path":"log/one","band":"Delain","status":200}'
+          , '{"uuid":"log-2","path":"log/two","band":"Within Temptation","status":200}'
+        ]
+    }
+
+    def __init__(self, log_dir):
+        self.log_dir = log_dir
+
+    def lines(self, name):
+        # TS adds the ".log" extension to text logs.
+        for path in [ os.path.join(self.log_dir, name + ".log"), os.path.join(self.log_dir, name) ]:
+            try:
+                with open(path, mode='r') as log:
+                    return log.readlines()
+            except:
+                pass
+        return []
+
+    def log_check(self):
+        return all(len(self.lines(name)) >= len(expected) for name, expected in self.records.items())
+
+    def validate(self):
+        result = ""
+        for name, expected in self.records.items():
+            lines = self.lines(name)
+            for record in expected:
+                if not any(l.rstrip('\n').endswith(' ' + record) for l in lines):
+                    result += "'{}' did not contain '{}'\n".format(name, record)
+        if len(result) == 0:
+            return ( True, self.Description, "OK")
+        return ( False, self.Description, result)
+
+tr = Test.TxnBoxTestAndRun("Structured logging", "log.replay.yaml", config_path='Auto', config_key='meta.txn_box.global'
+                , verifier_client_args="--verbose info"
+                )
+
+ts = tr.Variables.TS
+ts.Disk.records_config.update({
+      'proxy.config.diags.debug.enabled': 1
+    , 'proxy.config.diags.debug.tags': 'txn_box'
+    , 'proxy.config.http.cache.http':  0
+    , 'proxy.config.log.max_secs_per_buffer': 1
+})
+
+state = State(ts.Variables.LOGDIR)
+pv_client = tr.Variables.CLIENT
+
+# Wait for the records to be written, then check them.
+trailer = tr.Processes.Process("trailer")
+trailer.Command = "sh -c :"
+watcher = tr.Processes.Process("log-watch")
+watcher.Command = "sleep 1000"
+watcher.StartupTimeout = 60
+pv_client.StartAfter(watcher, ready=lambda : state.log_check())
+watcher.StartAfter(trailer)
+watcher.Streams.All.Content = Testers.Lambda(lambda info, tester : state.validate())
@@ -13,6 +13,8 @@ tr = Test.TxnBoxTestAndRun("Test modifiers", replay_file
                                 [ 'http://alpha.ex', [ '--key=meta.txn-box.alpha', replay_file]]
                               , [ 'http://bravo.ex', [ '--key=meta.txn-box.bravo', replay_file]]
                               , [ 'http://charlie.ex', [ '--key=meta.txn-box.charlie', replay_file]]
+                              , [ 'http://delta.ex', [ '--key=meta.txn-box.delta', replay_file]]
+                              , [ 'http://echo.ex', [ '--key=meta.txn-box.echo', replay_file]]
                              ]
                            )
 ts = tr.Variables.TS
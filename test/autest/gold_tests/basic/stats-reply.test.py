@@ -0,0 +1,34 @@
+# @file
+#
+# Copyright 2020, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+import os.path
+
+Test.Summary = '''
+Statistics reply.
+'''
+
+tr = Test.TxnBoxTestAndRun("Statistics reply", "stats-reply.replay.yaml", config_path='Auto', config_key='meta.txn_box.global'
+                , verifier_client_args="--verbose info"
+                )
+
+ts = tr.Variables.TS
+ts.Disk.records_config.update({
+      'proxy.config.diags.debug.enabled': 1
+    , 'proxy.config.diags.debug.tags': 'txn_box'
+    , 'proxy.config.http.cache.http':  0
+})
+
+# Check the bodies, which the verifier does not.
+probe_r = tr.Variables.TEST.AddTestRun()
+probe_r.Processes.Default.Command = "curl --silent --show-error http://127.0.0.1:{}/_stats/prometheus".format(ts.Variables.port)
+probe_r.Processes.Default.ReturnCode = 0
+probe_r.Processes.Default.Streams.stdout = Testers.ContainsExpression("plugin_txn_box_reply_count 7", "Checking Prometheus value")
+probe_r.Processes.Default.Streams.stdout += Testers.ContainsExpression("txn_box_config_generation", "Checking Prometheus generation")
+
+probe_r = tr.Variables.TEST.AddTestRun()
+probe_r.Processes.Default.Command = "curl --silent --show-error http://127.0.0.1:{}/_stats/json".format(ts.Variables.port)
+probe_r.Processes.Default.ReturnCode = 0
+probe_r.Processes.Default.Streams.stdout = Testers.ContainsExpression('"plugin.txn_box.reply.count":7', "Checking JSON value")
+probe_r.Processes.Default.Streams.stdout += Testers.ContainsExpression('"config":{"generation":', "Checking JSON generation")
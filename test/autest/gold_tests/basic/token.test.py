@@ -0,0 +1,18 @@
+# @file
+#
+# Copyright 2020, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+Test.Summary = '''
+Token verification - jwt-verify, jwt-claim, and url-sig-verify.
+'''
+
+tr = Test.TxnBoxTestAndRun("Token verification", "token.replay.yaml"
+                           , config_path='Auto', config_key="meta.txn_box.global"
+                           )
+ts = tr.Variables.TS
+ts.Disk.records_config.update({
+      'proxy.config.diags.debug.enabled': 1
+    , 'proxy.config.diags.debug.tags': 'txn_box'
+    , 'proxy.config.http.cache.http': 0
+})
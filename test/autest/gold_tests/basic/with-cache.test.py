@@ -0,0 +1,36 @@
+# @file
+#
+# Copyright 2020, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+import os.path
+
+Test.Summary = '''
+Selection cache for the with directive.
+'''
+
+tr = Test.TxnBoxTestAndRun("With cache", "with-cache.replay.yaml", config_path='Auto', config_key='meta.txn_box.global'
+                , verifier_client_args="--verbose info"
+                , command="traffic_manager"
+                )
+
+ts = tr.Variables.TS
+ts.Disk.records_config.update({
+      'proxy.config.diags.debug.enabled': 1
+    , 'proxy.config.diags.debug.tags': 'txn_box'
+    , 'proxy.config.http.cache.http':  0
+    , 'proxy.config.http.server_ports': '{0}'.format(ts.Variables.port)
+})
+
+probe_r = tr.Variables.TEST.AddTestRun()
+probe_r.DelayStart = 20
+probe_r.Processes.Default.Command = "traffic_ctl metric get plugin.test.with-cache.hit"
+probe_r.Processes.Default.Env = ts.Env
+probe_r.Processes.Default.ReturnCode = 0
+probe_r.Processes.Default.Streams.stdout = Testers.ContainsExpression("with-cache.hit 3", "Checking cache hits")
+
+probe_r = tr.Variables.TEST.AddTestRun()
+probe_r.Processes.Default.Command = "traffic_ctl metric get plugin.test.with-cache.miss"
+probe_r.Processes.Default.Env = ts.Env
+probe_r.Processes.Default.ReturnCode = 0
+probe_r.Processes.Default.Streams.stdout = Testers.ContainsExpression("with-cache.miss 4", "Checking cache misses")
@@ -0,0 +1,95 @@
+# @file
+#
+# Copyright 2020, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+import os.path
+
+Test.Summary = '''
+Upstream pool selection and failover.
+'''
+
+RepeatCount = 1000
+CFG_PATH = "pool.cfg.yaml"
+
+class State:
+    # Expected fraction of responses from each origin, in percent. The dead member must fail at
+    # most once before it is put in cooldown, after which its selections go to the next member.
+    targets = { "one" : 80, "two" : 20 }
+    Description = "Checking upstream distribution."
+
+    def counts(self, log_path):
+        counts = { "one" : 0, "two" : 0, "-" : 0 }
+        try:
+            with open(log_path, mode='r') as log:
+                for l in log.readlines():
+                    l = l.strip()
+                    if l in counts:
+                        counts[l] += 1
+        except:
+            pass
+        return counts
+
+    def validate(self, log_path):
+        counts = self.counts(log_path)
+        result = ""
+        for name, target in self.targets.items():
+            lower = int((RepeatCount * (target - 5)) / 100)
+            upper = int((RepeatCount * (target + 5)) / 100)
+            if counts[name] < lower or counts[name] > upper:
+                result += "'{}' had {} not in {}..{}\n".format(name, counts[name], lower, upper)
+        if counts["-"] > 1:
+            result += "{} failed transactions, the dead member was not put in cooldown.\n".format(counts["-"])
+        if len(result) == 0:
+            return ( True, self.Description, "OK")
+        return ( False, self.Description, result)
+
+    def log_check(self, log_path):
+        return sum(self.counts(log_path).values()) >= RepeatCount
+
+tr = Test.TxnBoxTestAndRun("Upstream pool", "pool.replay.yaml"
+                           , remap=[ ['http://pool.ex', [ CFG_PATH ] ] ]
+                           , verifier_client_args="--verbose info --repeat {}".format(RepeatCount)
+                           )
+
+ts = tr.Variables.TS
+pv_one = tr.Variables.SERVER
+pv_two = Test.MakeVerifierServerProcess("pv-server-2", "pool-2.replay.yaml")
+tr.Processes.Default.StartBefore(pv_two)
+
+# Member ports are not known until the servers are created, so the configuration is generated.
+# Port 1 is the dead member, nothing listens there.
+ts.Disk.File(os.path.join(ts.Variables.CONFIGDIR, CFG_PATH), id="pool_cfg", typename="ats:config")
+ts.Disk.pool_cfg.AddLines([
+  '- upstream-pool-define:'
+, '    name: "origins"'
+, '    failures: 1'
+, '    cooldown: 1h'
+, '    members:'
+, '    - addr: "127.0.0.1:{}"'.format(pv_one.Variables.http_port)
+, '      weight: 3'
+, '    - "127.0.0.1:{}"'.format(pv_two.Variables.http_port)
+, '    - "127.0.0.1:1"'
+, '- upstream-pool: "origins"'
+])
+
+ts.Setup.Copy("pool.logging.yaml", os.path.join(ts.Variables.CONFIGDIR, "logging.yaml"))
+ts.Disk.records_config.update({
+    'proxy.config.http.cache.http': 0
+  , 'proxy.config.http.connect_attempts_max_retries': 0
+  , 'proxy.config.log.max_secs_per_buffer': 1
+})
+
+state = State()
+pv_client = tr.Variables.CLIENT
+
+# Wait for the log to be written, then check the distribution.
+trailer = tr.Processes.Process("trailer")
+trailer.Command = "sh -c :"
+watcher = tr.Processes.Process("log-watch")
+watcher.Command = "sleep 1000"
+watcher.StartupTimeout = 120
+log_path = os.path.join(ts.Variables.LOGDIR, "pool.log")
+pv_client.StartAfter(watcher, ready=lambda : state.log_check(log_path))
+watcher.StartAfter(trailer)
+watcher.Streams.All.Content = Testers.Lambda(lambda info, tester : state.validate(log_path))
@@ -0,0 +1,18 @@
+# @file
+#
+# Copyright 2020, Verizon Media
+# SPDX-License-Identifier: Apache-2.0
+#
+Test.Summary = '''
+Stable bucketing - the same key is in the same bucket on every request, and salts are independent.
+'''
+
+tr = Test.TxnBoxTestAndRun("Bucketing", "bucket.replay.yaml"
+                           , config_path='Auto', config_key="meta.txn_box.global"
+                           )
+ts = tr.Variables.TS
+ts.Disk.records_config.update({
+      'proxy.config.http.cache.http': 0
+    , 'proxy.config.diags.debug.enabled': 1
+    , 'proxy.config.diags.debug.tags': 'txn_box'
+})
@@ -0,0 +1,129 @@
+/** @file
+ * Load a configuration offline and report on its contents.
+ *
+ * The configuration is loaded exactly as the plugin would, using the mock TS API, and then the
+ * elements of the configuration are reported - load time per file, directive, comparison, and
+ * regular expression counts per hook, comparisons that are candidates for acceleration, capture
+ * group and context storage requirements, localized text deduplication, and a rough relative cost
+ * per hook. The exit status is non-zero if the configuration fails to load, so this can be used as
+ * a check before deployment.
+ *
+ * Usage: txn_box_analyze [--remap] [--verbose] <plugin arguments>...
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <swoc/TextView.h>
+#include <swoc/bwf_base.h>
+#include <swoc/bwf_std.h>
+
+#include "txn_box/common.h"
+#include "txn_box/Config.h"
+
+#include "ts_mock.h"
+
+using swoc::TextView;
+using namespace swoc::literals;
+
+namespace
+{
+/** Relative cost weights for the per hook estimate.
+ *
+ * These are not measurements, only a rough ordering so that hooks with a lot of work stand out.
+ * Use @c txn_box_replay to measure actual CPU time.
+ */
+constexpr unsigned DIRECTIVE_WEIGHT  = 1;
+constexpr unsigned COMPARISON_WEIGHT = 1;
+constexpr unsigned RXP_WEIGHT        = 4;
+
+void
+usage()
+{
+  fputs("Usage: txn_box_analyze [--remap] [--verbose] <plugin arguments>...\n", stderr);
+}
+
+} // namespace
+
+int
+main(int argc, char const *argv[])
+{
+  bool remap_p   = false;
+  bool verbose_p = false;
+  // Arguments passed to the configuration load, with a leading placeholder for the plugin name.
+  std::vector<char const *> args{"txn_box.so"};
+
+  for (int idx = 1; idx < argc; ++idx) {
+    TextView arg{argv[idx], strlen(argv[idx])};
+    if (arg == "--remap"_tv) {
+      remap_p = true;
+    } else if (arg == "--verbose"_tv) {
+      verbose_p = true;
+    } else {
+      args.push_back(argv[idx]);
+    }
+  }
+
+  if (args.size() < 2) {
+    usage();
+    return 1;
+  }
+
+  ts_mock::diag_enable(verbose_p);
+  auto cfg = std::make_shared<Config>();
+  if (remap_p) {
+    cfg->mark_as_remap();
+  }
+  auto t0     = std::chrono::steady_clock::now();
+  auto errata = cfg->load_cli_args(cfg, swoc::MemSpan<char const *>{args.data(), args.size()}, 1);
+  auto delta  = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0);
+
+  std::string text;
+  if (!errata.is_ok()) {
+    fputs(swoc::bwprint(text, "Configuration failed to load.\n{}\n", errata).c_str(), stderr);
+    return 1;
+  }
+
+  auto const &counts = cfg->element_counts();
+  auto mem           = cfg->memory_info();
+  unsigned n_cmp     = 0;
+  for (auto n : counts._comparisons) {
+    n_cmp += n;
+  }
+
+  printf("load time %.3f ms\n", delta.count() / 1e6);
+  for (auto const &[path, t] : cfg->file_load_times()) {
+    printf("  %10.3f ms  %s\n", t.count() / 1e6, path.c_str());
+  }
+  printf("directives %zu\n", mem._directive_count);
+  printf("comparisons %u, pure %u, string accelerator candidates %u\n", n_cmp, counts._pure_comparisons,
+         counts._accelerators[Accelerator::BY_STRING]);
+  printf("regular expressions %zu, %zu bytes\n", mem._rxp_count, mem._rxp_bytes);
+  printf("capture groups %u\n", cfg->capture_group_count());
+  printf("reserved context storage %zu bytes\n", cfg->reserved_ctx_storage_size());
+  printf("config arena %zu bytes allocated, %zu bytes reserved\n", mem._arena_allocated, mem._arena_reserved);
+  printf("localized text %zu strings, %zu bytes, %zu bytes stored, dedup ratio %.2f\n", mem._text_count, mem._text_bytes,
+         mem._text_stored, mem._text_stored ? double(mem._text_bytes) / mem._text_stored : 1.0);
+
+  printf("%-16s %10s %11s %6s %9s\n", "hook", "directives", "comparisons", "rxps", "est. cost");
+  for (unsigned idx = IndexFor(Hook::POST_LOAD); idx < std::tuple_size<Hook>::value; ++idx) {
+    auto n_drtv = counts._directives[idx];
+    auto n_hcmp = counts._comparisons[idx];
+    auto n_rxp  = counts._rxps[idx];
+    if (n_drtv == 0 && n_hcmp == 0 && n_rxp == 0) {
+      continue;
+    }
+    swoc::bwprint(text, "{}", Hook(idx));
+    printf("%-16s %10u %11u %6u %9u\n", text.c_str(), n_drtv, n_hcmp, n_rxp,
+           n_drtv * DIRECTIVE_WEIGHT + n_hcmp * COMPARISON_WEIGHT + n_rxp * RXP_WEIGHT);
+  }
+  printf("cost weights: directive %u, comparison %u, regular expression %u\n", DIRECTIVE_WEIGHT, COMPARISON_WEIGHT, RXP_WEIGHT);
+
+  return 0;
+}
@@ -0,0 +1,460 @@
+/** @file
+ * Micro benchmarks for comparisons, feature expressions, and modifiers.
+ *
+ * Each case is run against transactions loaded from replay files, using the mock TS API. The cost
+ * of creating the transaction and context is excluded, only the operation itself is timed. For
+ * every case the time and the number of heap allocations per operation is reported. Context arena
+ * memory is not counted as heap allocations. The size of @c Feature and its members is reported
+ * first, followed by the cost of copying features and of building tuples, and the cost of a
+ * transaction with a single hook, including creating and destroying the context. The last includes
+ * the mock transaction close but not the mock transaction creation.
+ *
+ * Usage: bench_txn_box [--time <ms>] [--filter <text>] [--cases <file>] <replay-file>...
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <swoc/TextView.h>
+#include <swoc/bwf_base.h>
+
+#include "txn_box/common.h"
+#include "txn_box/yaml_util.h"
+#include "txn_box/Comparison.h"
+#include "txn_box/Expr.h"
+#include "txn_box/Config.h"
+#include "txn_box/Context.h"
+
+#include "ts_mock.h"
+#include "replay.h"
+
+using swoc::TextView;
+using swoc::Errata;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+// Count heap allocations.
+
+namespace
+{
+std::atomic<uint64_t> Alloc_Count{0};
+std::atomic<uint64_t> Alloc_Bytes{0};
+} // namespace
+
+void *
+operator new(size_t n)
+{
+  Alloc_Count.fetch_add(1, std::memory_order_relaxed);
+  Alloc_Bytes.fetch_add(n, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(n ? n : 1); ptr) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void *ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+/* ------------------------------------------------------------------------------------ */
+namespace
+{
+/// Default benchmark cases. Each group is a list of cases, each case has a name and an expression.
+/// Comparison cases also have a comparison which is applied to the feature from the expression.
+constexpr TextView DEFAULT_CASES = R"(
+comparison:
+- { name: "match", expr: ua-req-host, cmp: { match: "example.one" } }
+- { name: "match<nc>", expr: ua-req-host, cmp: { "match<nc>": "EXAMPLE.ONE" } }
+- { name: "match-list", expr: ua-req-host, cmp: { match: [ "one.example", "two.example", "example.one", "example.two" ] } }
+- { name: "prefix", expr: ua-req-path, cmp: { prefix: "config/" } }
+- { name: "prefix<nc>", expr: ua-req-path, cmp: { "prefix<nc>": "CONFIG/" } }
+- { name: "suffix", expr: ua-req-path, cmp: { suffix: ".yaml" } }
+- { name: "contains", expr: ua-req-url, cmp: { contains: "settings" } }
+- { name: "tld", expr: ua-req-host, cmp: { tld: "one" } }
+- { name: "path", expr: ua-req-path, cmp: { path: "config/settings.yaml" } }
+- { name: "rxp", expr: ua-req-path, cmp: { rxp: "^([^/]+)/(.*)[.]yaml$" } }
+- { name: "rxp<nc>", expr: ua-req-path, cmp: { "rxp<nc>": "^CONFIG/" } }
+- { name: "rxp-list", expr: ua-req-path, cmp: { rxp: [ "^images/", "^static/", "[.]yaml$" ] } }
+- { name: "rxp-dynamic", expr: ua-req-path, cmp: { rxp: "^{ua-req-host}" } }
+- { name: "eq-integer", expr: ua-req-port, cmp: { eq: 80 } }
+- { name: "lt-integer", expr: ua-req-port, cmp: { lt: 1024 } }
+- { name: "in-integer", expr: ua-req-port, cmp: { in: [ 1, 1023 ] } }
+- { name: "in-ip", expr: inbound-addr-remote, cmp: { in: "172.16.0.0/12" } }
+- { name: "is-empty", expr: ua-req-field<Accept>, cmp: { is-empty: } }
+- { name: "is-null", expr: ua-req-field<Accept>, cmp: { is-null: } }
+- { name: "otherwise", expr: ua-req-host, cmp: { otherwise: } }
+- { name: "any-of", expr: ua-req-host, cmp: { any-of: [ { match: "one.example" }, { suffix: ".one" }, { prefix: "example." } ] } }
+- { name: "all-of", expr: ua-req-host, cmp: { all-of: [ { prefix: "example." }, { suffix: ".one" } ] } }
+- { name: "none-of", expr: ua-req-host, cmp: { none-of: [ { match: "one.example" }, { match: "two.example" } ] } }
+- { name: "for-any", expr: [ ua-req-host, ua-req-path ], cmp: { for-any: { match: "example.one" } } }
+- { name: "for-all", expr: [ ua-req-host, ua-req-path ], cmp: { for-all: { contains: "e" } } }
+- { name: "as-tuple", expr: [ ua-req-host, ua-req-path ], cmp: { as-tuple: [ { tld: "one" }, { prefix: "config/" } ] } }
+
+expression:
+- { name: "literal", expr: "example.one" }
+- { name: "direct", expr: ua-req-host }
+- { name: "direct-field", expr: ua-req-field<Host> }
+- { name: "composite", expr: "{ua-req-host}/{ua-req-path}" }
+- { name: "composite-format", expr: "{ua-req-host}:{ua-req-port}" }
+- { name: "list", expr: [ ua-req-host, ua-req-path, ua-req-method ] }
+- { name: "random", expr: random }
+- { name: "bucket", expr: bucket<10> }
+
+modifier:
+- { name: "else", expr: [ ua-req-field<Accept>, { else: "*/*" } ] }
+- { name: "hash", expr: [ ua-req-url, { hash: 16 } ] }
+- { name: "digest-wyhash", expr: [ ua-req-url, { digest: wyhash } ] }
+- { name: "digest-sha256", expr: [ ua-req-url, { digest: { algorithm: sha256, format: base64 } } ] }
+- { name: "digest-hmac", expr: [ ua-req-url, { digest: { algorithm: hmac-sha256, secret: "shared-secret" } } ] }
+- { name: "consistent-hash", expr: [ ua-req-path, { consistent-hash: [ "cache-1", "cache-2", { member: "cache-3", weight: 2 } ] } ] }
+- { name: "join", expr: [ [ ua-req-host, ua-req-path ], { join: "/" } ] }
+- { name: "concat", expr: [ ua-req-path, { concat: [ "/", ua-req-host ] } ] }
+- { name: "as-bool", expr: [ ua-req-field<Host>, { as-bool: } ] }
+- { name: "as-integer", expr: [ "{ua-req-port}", { as-integer: } ] }
+- { name: "as-duration", expr: [ "90s", { as-duration: } ] }
+- { name: "as-ip-addr", expr: [ "{inbound-addr-remote}", { as-ip-addr: } ] }
+- { name: "filter", expr: [ [ ua-req-host, ua-req-path ], { filter: [ { match: "example.one", drop: }, { pass: } ] } ] }
+- { name: "rxp-replace", expr: [ ua-req-path, { rxp-replace: [ "^config/", "cfg/" ] } ] }
+- { name: "url-encode", expr: [ ua-req-url, { url-encode: } ] }
+- { name: "url-decode", expr: [ ua-req-url, { url-decode: } ] }
+- { name: "base64-encode", expr: [ ua-req-url, { base64-encode: url } ] }
+- { name: "base64-decode", expr: [ "ZXhhbXBsZS5vbmUvY29uZmlnL3BhdGg=", { base64-decode: } ] }
+- { name: "query-sort", expr: [ ua-req-query, { query-sort: } ] }
+- { name: "query-filter", expr: [ ua-req-query, { query-filter: [ { prefix: "utm_", drop: }, { pass: } ] } ] }
+)";
+
+/// Operations per context. Contexts are recreated periodically to keep arena growth bounded.
+constexpr unsigned BATCH = 256;
+
+/// Prevent the optimizer from discarding @a value.
+template <typename T>
+inline void
+keep(T const &value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+/// A single benchmark case.
+struct Case {
+  std::string _name;          ///< Full name - "group/name".
+  Expr _expr;                 ///< Feature expression.
+  Comparison::Handle _cmp;    ///< Comparison, if any.
+};
+
+/// Benchmark driver.
+class Bench
+{
+public:
+  /// Operation to time, for the context of a transaction.
+  using Op = std::function<void()>;
+  /// Prepare an operation on a context.
+  using Prepare = std::function<Op(Context &)>;
+
+  Bench(std::chrono::milliseconds min_time) : _cfg(std::make_shared<Config>()), _min_time(min_time) {}
+
+  /// Load the cases from @a root.
+  Errata load(YAML::Node const &root, TextView filter);
+
+  /// Run all the cases against @a txns.
+  void run(std::vector<ts_mock::ReplayTxn> const &txns);
+
+protected:
+  Config::Handle _cfg;
+  std::chrono::milliseconds _min_time;
+  std::vector<Case> _cases;
+  TSHttpSsn _ssn = nullptr;
+  TextView _filter; ///< Only run cases that contain this.
+
+  /// Report the size of @c Feature and its member types.
+  void feature_sizes();
+
+  /// Time copying features and building tuples.
+  void feature_cases(std::vector<ts_mock::ReplayTxn> const &txns);
+
+  /// Time the transaction life cycle - context creation, hook setup and dispatch, and cleanup.
+  void txn_cases(std::vector<ts_mock::ReplayTxn> const &txns);
+
+  /// Time @a prepare and print the result.
+  void measure(TextView name, std::vector<ts_mock::ReplayTxn> const &txns, Prepare const &prepare);
+};
+
+Errata
+Bench::load(YAML::Node const &root, TextView filter)
+{
+  _filter = filter;
+  for (auto const &[group_node, case_list] : root) {
+    TextView group{group_node.Scalar()};
+    bool cmp_p = (group == "comparison");
+    if (!case_list.IsSequence()) {
+      return Errata(S_ERROR, R"(Benchmark group "{}" at {} is not a list.)", group, case_list.Mark());
+    }
+    for (auto const &case_node : case_list) {
+      Case c;
+      swoc::bwprint(c._name, "{}/{}", group, case_node["name"].Scalar());
+      if (!filter.empty() && TextView{c._name}.find(filter) == TextView::npos) {
+        continue;
+      }
+      auto &&[expr, errata]{_cfg->parse_expr(case_node["expr"])};
+      if (!errata.is_ok()) {
+        errata.note(R"(While parsing expression for benchmark "{}".)", c._name);
+        return std::move(errata);
+      }
+      if (cmp_p) {
+        auto scope{_cfg->feature_scope(expr.result_type())};
+        auto &&[cmp, cmp_errata]{Comparison::load(*_cfg, case_node["cmp"])};
+        if (!cmp_errata.is_ok()) {
+          cmp_errata.note(R"(While parsing comparison for benchmark "{}".)", c._name);
+          return std::move(cmp_errata);
+        }
+        c._cmp = std::move(cmp);
+      }
+      c._expr = std::move(expr);
+      _cases.emplace_back(std::move(c));
+    }
+  }
+  return {};
+}
+
+void
+Bench::measure(TextView name, std::vector<ts_mock::ReplayTxn> const &txns, Prepare const &prepare)
+{
+  using clock = std::chrono::steady_clock;
+  std::chrono::nanoseconds elapsed{0};
+  uint64_t n_ops   = 0;
+  uint64_t n_alloc = 0;
+  uint64_t n_bytes = 0;
+  size_t idx       = 0;
+
+  while (elapsed < _min_time) {
+    auto const &src = txns[idx++ % txns.size()];
+    auto txn        = ts_mock::txn_create(_ssn);
+    ts_mock::hdr_assign(txn, ts_mock::Hdr::UA_REQ, src._ua_req);
+    if (!src._upstream_rsp.empty()) {
+      ts_mock::hdr_assign(txn, ts_mock::Hdr::UPSTREAM_RSP, src._upstream_rsp);
+    }
+    auto ctx = new Context(_cfg);
+    ctx->enable_hooks(txn); // @a ctx is destroyed when @a txn is closed.
+    auto op = prepare(*ctx);
+
+    auto a0 = Alloc_Count.load(std::memory_order_relaxed);
+    auto b0 = Alloc_Bytes.load(std::memory_order_relaxed);
+    auto t0 = clock::now();
+    for (unsigned i = 0; i < BATCH; ++i) {
+      op();
+    }
+    elapsed += clock::now() - t0;
+    n_alloc += Alloc_Count.load(std::memory_order_relaxed) - a0;
+    n_bytes += Alloc_Bytes.load(std::memory_order_relaxed) - b0;
+    n_ops += BATCH;
+
+    ts_mock::txn_close(txn);
+  }
+
+  printf("%-40.*s %12.1f %10.3f %12.1f\n", int(name.size()), name.data(), double(elapsed.count()) / n_ops, double(n_alloc) / n_ops,
+         double(n_bytes) / n_ops);
+}
+
+void
+Bench::feature_sizes()
+{
+  printf("sizeof Feature %zu, FeatureView %zu, IPAddr %zu, FeatureTuple %zu, duration %zu\n", sizeof(Feature),
+         sizeof(FeatureView), sizeof(swoc::IPAddr), sizeof(FeatureTuple), sizeof(feature_type_for<DURATION>));
+}
+
+void
+Bench::feature_cases(std::vector<ts_mock::ReplayTxn> const &txns)
+{
+  static constexpr unsigned N = 8; // Features per operation.
+  auto selected               = [&](TextView name) { return _filter.empty() || name.find(_filter) != TextView::npos; };
+
+  // A mix of feature types as would be seen in a transaction.
+  auto fill = [](Feature *features) {
+    for (unsigned idx = 0; idx < N; idx += 4) {
+      features[idx]     = FeatureView::Literal("example.one");
+      features[idx + 1] = feature_type_for<INTEGER>(idx);
+      features[idx + 2] = swoc::IPAddr{"172.16.10.10"};
+      features[idx + 3] = feature_type_for<DURATION>(idx);
+    }
+  };
+
+  if (TextView name = "feature/copy"; selected(name)) {
+    this->measure(name, txns, [&](Context &) -> Op {
+      auto src = std::make_shared<std::array<Feature, N>>();
+      fill(src->data());
+      return [src]() {
+        std::array<Feature, N> dst;
+        for (unsigned idx = 0; idx < N; ++idx) {
+          dst[idx] = (*src)[idx];
+        }
+        keep(dst);
+      };
+    });
+  }
+
+  if (TextView name = "feature/tuple"; selected(name)) {
+    this->measure(name, txns, [&](Context &ctx) -> Op {
+      auto src = std::make_shared<std::array<Feature, N>>();
+      fill(src->data());
+      return [&ctx, src]() {
+        auto span = ctx.alloc_span<Feature>(N);
+        for (unsigned idx = 0; idx < N; ++idx) {
+          span[idx] = (*src)[idx];
+        }
+        keep(Feature{span});
+      };
+    });
+  }
+}
+
+void
+Bench::txn_cases(std::vector<ts_mock::ReplayTxn> const &txns)
+{
+  using clock = std::chrono::steady_clock;
+  TextView name = "txn/lifecycle";
+  if (!_filter.empty() && name.find(_filter) == TextView::npos) {
+    return;
+  }
+
+  // The configuration has a directive on the request hook, so that hook is dispatched as well as
+  // the close hook.
+  auto cfg = std::make_shared<Config>();
+  if (auto errata = cfg->parse_yaml(YAML::Load("[ { when: ua-req, do: [ { ua-req-field<Bench>: \"1\" } ] } ]"), ".");
+      !errata.is_ok()) {
+    std::string text;
+    fputs(swoc::bwprint(text, "{}\n", errata).c_str(), stderr);
+    return;
+  }
+
+  std::chrono::nanoseconds elapsed{0};
+  uint64_t n_ops   = 0;
+  uint64_t n_alloc = 0;
+  uint64_t n_bytes = 0;
+  size_t idx       = 0;
+
+  while (elapsed < _min_time) {
+    auto const &src = txns[idx++ % txns.size()];
+    auto txn        = ts_mock::txn_create(_ssn);
+    ts_mock::hdr_assign(txn, ts_mock::Hdr::UA_REQ, src._ua_req);
+
+    auto a0 = Alloc_Count.load(std::memory_order_relaxed);
+    auto b0 = Alloc_Bytes.load(std::memory_order_relaxed);
+    auto t0 = clock::now();
+    auto ctx = new Context(cfg);
+    ctx->enable_hooks(txn);
+    ts_mock::hook_invoke(txn, TS_HTTP_READ_REQUEST_HDR_HOOK);
+    ts_mock::txn_close(txn); // destroys @a ctx.
+    elapsed += clock::now() - t0;
+    n_alloc += Alloc_Count.load(std::memory_order_relaxed) - a0;
+    n_bytes += Alloc_Bytes.load(std::memory_order_relaxed) - b0;
+    ++n_ops;
+  }
+
+  printf("%-40.*s %12.1f %10.3f %12.1f\n", int(name.size()), name.data(), double(elapsed.count()) / n_ops, double(n_alloc) / n_ops,
+         double(n_bytes) / n_ops);
+}
+
+void
+Bench::run(std::vector<ts_mock::ReplayTxn> const &txns)
+{
+  swoc::IPEndpoint remote, local;
+  remote.parse("172.16.10.10:50000");
+  local.parse("10.10.10.10:80");
+  _ssn = ts_mock::ssn_create(remote, local);
+
+  this->feature_sizes();
+  printf("%-40s %12s %10s %12s\n", "case", "ns/op", "allocs/op", "bytes/op");
+  this->feature_cases(txns);
+  this->txn_cases(txns);
+
+  for (auto const &c : _cases) {
+    if (c._cmp) {
+      this->measure(c._name, txns, [&](Context &ctx) -> Op {
+        Feature feature{ctx.extract(c._expr)};
+        ctx.commit(feature);
+        return [&ctx, &c, feature]() { keep((*c._cmp)(ctx, feature)); };
+      });
+    } else {
+      this->measure(c._name, txns, [&](Context &ctx) -> Op { return [&ctx, &c]() { keep(ctx.extract(c._expr)); }; });
+    }
+  }
+
+  ts_mock::ssn_destroy(_ssn);
+  _ssn = nullptr;
+}
+
+} // namespace
+
+int
+main(int argc, char const *argv[])
+{
+  std::chrono::milliseconds min_time{200};
+  TextView filter;
+  std::string cases_path;
+  std::vector<ts_mock::ReplayTxn> txns;
+
+  for (int idx = 1; idx < argc; ++idx) {
+    TextView arg{argv[idx], strlen(argv[idx])};
+    if (arg == "--time"_tv && idx + 1 < argc) {
+      ++idx;
+      min_time = std::chrono::milliseconds(swoc::svtou(TextView{argv[idx], strlen(argv[idx])}));
+    } else if (arg == "--filter"_tv && idx + 1 < argc) {
+      ++idx;
+      filter.assign(argv[idx], strlen(argv[idx]));
+    } else if (arg == "--cases"_tv && idx + 1 < argc) {
+      cases_path = argv[++idx];
+    } else if (auto errata = ts_mock::replay_load(swoc::file::path{arg}, txns); !errata.is_ok()) {
+      std::string text;
+      fputs(swoc::bwprint(text, "{}\n", errata).c_str(), stderr);
+      return 1;
+    }
+  }
+
+  if (txns.empty()) {
+    fputs("Usage: bench_txn_box [--time <ms>] [--filter <text>] [--cases <file>] <replay-file>...\n", stderr);
+    return 1;
+  }
+
+  G.reserve_txn_arg();
+
+  YAML::Node root;
+  if (cases_path.empty()) {
+    root = YAML::Load(std::string{DEFAULT_CASES});
+  } else {
+    auto &&[node, errata]{yaml_load(cases_path)};
+    if (!errata.is_ok()) {
+      std::string text;
+      fputs(swoc::bwprint(text, "{}\n", errata).c_str(), stderr);
+      return 1;
+    }
+    root = node;
+  }
+
+  Bench bench{min_time};
+  if (auto errata = bench.load(root, filter); !errata.is_ok()) {
+    std::string text;
+    fputs(swoc::bwprint(text, "{}\n", errata).c_str(), stderr);
+    return 1;
+  }
+  bench.run(txns);
+  return 0;
+}
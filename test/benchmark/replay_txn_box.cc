@@ -0,0 +1,217 @@
+/** @file
+ * Drive transactions from replay files through a configuration.
+ *
+ * The configuration is loaded as the global plugin configuration with the mock TS API. Each
+ * transaction in the replay files is then run through the transaction hooks in order. The CPU
+ * time for each hook, the overall throughput, and the context arena memory used per transaction
+ * are reported. CPU time includes the overhead of the mock TS API, which is small compared to
+ * directive invocation but not zero.
+ *
+ * Usage: txn_box_replay [--threads <n>] [--txns <n>] [--key <key>] [--verbose] <config> <replay-file>...
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <swoc/TextView.h>
+#include <swoc/bwf_base.h>
+
+#include "txn_box/common.h"
+#include "txn_box/ts_util.h"
+#include "txn_box/Context.h"
+
+#include "ts_mock.h"
+#include "replay.h"
+
+using swoc::TextView;
+using namespace swoc::literals;
+
+namespace
+{
+/// Hooks invoked for each transaction, in order.
+constexpr std::array<Hook, 8> HOOKS{Hook::TXN_START, Hook::CREQ, Hook::PRE_REMAP, Hook::POST_REMAP,
+                                    Hook::PREQ,      Hook::URSP, Hook::PRSP,      Hook::TXN_CLOSE};
+
+/// Per thread results.
+struct Result {
+  uint64_t _txn_count = 0;                         ///< Transactions run.
+  std::array<uint64_t, HOOKS.size()> _cpu_ns{};    ///< CPU time per hook.
+  uint64_t _arena_bytes = 0;                       ///< Total context arena bytes.
+  uint64_t _arena_max   = 0;                       ///< Largest context arena.
+  uint64_t _error_count = 0;                       ///< Transactions that reenabled with an error.
+
+  Result &
+  operator+=(Result const &that)
+  {
+    _txn_count += that._txn_count;
+    for (unsigned idx = 0; idx < _cpu_ns.size(); ++idx) {
+      _cpu_ns[idx] += that._cpu_ns[idx];
+    }
+    _arena_bytes += that._arena_bytes;
+    _arena_max = std::max(_arena_max, that._arena_max);
+    _error_count += that._error_count;
+    return *this;
+  }
+};
+
+/// @return CPU time used by the calling thread.
+uint64_t
+thread_cpu_ns()
+{
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/// Run @a n transactions from @a txns, starting at @a offset.
+void
+drive(std::vector<ts_mock::ReplayTxn> const &txns, size_t offset, uint64_t n, Result &result)
+{
+  swoc::IPEndpoint remote, local;
+  remote.parse("172.16.10.10:50000");
+  local.parse("10.10.10.10:80");
+  auto ssn = ts_mock::ssn_create(remote, local);
+
+  for (uint64_t count = 0; count < n; ++count) {
+    auto const &src = txns[(offset + count) % txns.size()];
+    auto txn        = ts_mock::txn_create(ssn);
+    ts_mock::hdr_assign(txn, ts_mock::Hdr::UA_REQ, src._ua_req);
+    if (!src._upstream_rsp.empty()) {
+      ts_mock::hdr_assign(txn, ts_mock::Hdr::UPSTREAM_RSP, src._upstream_rsp);
+    }
+
+    bool error_p = false;
+    for (unsigned idx = 0; idx < HOOKS.size(); ++idx) {
+      auto hook = HOOKS[idx];
+      // After an error, TS goes directly to sending the response.
+      if (error_p && hook != Hook::PRSP && hook != Hook::TXN_CLOSE) {
+        continue;
+      }
+      if (hook == Hook::TXN_CLOSE) {
+        if (auto ctx = static_cast<Context *>(TSUserArgGet(txn, G.TxnArgIdx)); ctx) {
+          auto size = ctx->arena_size();
+          result._arena_bytes += size;
+          result._arena_max = std::max<uint64_t>(result._arena_max, size);
+        }
+        auto t0 = thread_cpu_ns();
+        ts_mock::txn_close(txn);
+        result._cpu_ns[idx] += thread_cpu_ns() - t0;
+      } else {
+        auto t0 = thread_cpu_ns();
+        auto evt = ts_mock::hook_invoke(txn, TS_Hook[IndexFor(hook)]);
+        result._cpu_ns[idx] += thread_cpu_ns() - t0;
+        if (evt == TS_EVENT_HTTP_ERROR && !error_p) {
+          error_p = true;
+          ++result._error_count;
+        }
+      }
+    }
+    ++result._txn_count;
+  }
+
+  ts_mock::ssn_destroy(ssn);
+}
+
+void
+usage()
+{
+  fputs("Usage: txn_box_replay [--threads <n>] [--txns <n>] [--key <key>] [--verbose] <config> <replay-file>...\n", stderr);
+}
+
+} // namespace
+
+int
+main(int argc, char const *argv[])
+{
+  unsigned n_threads = 1;
+  uint64_t n_txns    = 0; // per thread, 0 => one pass over the replay transactions.
+  bool verbose_p     = false;
+  std::string key{"txn_box"};
+  std::string cfg_path;
+  std::vector<ts_mock::ReplayTxn> txns;
+
+  for (int idx = 1; idx < argc; ++idx) {
+    TextView arg{argv[idx], strlen(argv[idx])};
+    if (arg == "--threads"_tv && idx + 1 < argc) {
+      ++idx;
+      n_threads = std::max<unsigned>(1, swoc::svtou(TextView{argv[idx], strlen(argv[idx])}));
+    } else if (arg == "--txns"_tv && idx + 1 < argc) {
+      ++idx;
+      n_txns = swoc::svtou(TextView{argv[idx], strlen(argv[idx])});
+    } else if (arg == "--key"_tv && idx + 1 < argc) {
+      key = argv[++idx];
+    } else if (arg == "--verbose"_tv) {
+      verbose_p = true;
+    } else if (cfg_path.empty()) {
+      cfg_path = arg;
+    } else if (auto errata = ts_mock::replay_load(swoc::file::path{arg}, txns); !errata.is_ok()) {
+      std::string text;
+      fputs(swoc::bwprint(text, "{}\n", errata).c_str(), stderr);
+      return 1;
+    }
+  }
+
+  if (cfg_path.empty() || txns.empty()) {
+    usage();
+    return 1;
+  }
+  if (n_txns == 0) {
+    n_txns = txns.size();
+  }
+
+  ts_mock::diag_enable(verbose_p);
+  char const *plugin_argv[] = {"txn_box.so", "--key", key.c_str(), cfg_path.c_str()};
+  TSPluginInit(4, plugin_argv);
+  if (auto n = ts_mock::diag_error_count_reset(); n > 0) {
+    fprintf(stderr, "%u errors loading configuration \"%s\"%s.\n", n, cfg_path.c_str(), verbose_p ? "" : " - use --verbose for details");
+    return 1;
+  }
+
+  std::vector<Result> results(n_threads);
+  std::vector<std::thread> threads;
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned idx = 0; idx < n_threads; ++idx) {
+    // Stagger the starting transaction so threads aren't in lock step.
+    threads.emplace_back(&drive, std::cref(txns), (idx * txns.size()) / n_threads, n_txns, std::ref(results[idx]));
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0);
+  ts_mock::task_run();
+
+  Result total;
+  for (auto const &r : results) {
+    total += r;
+  }
+
+  uint64_t cpu_ns = 0;
+  for (auto n : total._cpu_ns) {
+    cpu_ns += n;
+  }
+  double n = total._txn_count;
+  printf("threads %u, transactions %" PRIu64 ", errors %" PRIu64 ", wall time %.1f ms\n", n_threads, total._txn_count,
+         total._error_count, wall.count() / 1e6);
+  printf("throughput %.0f txn/sec, cpu %.1f ns/txn\n", n / (wall.count() / 1e9), cpu_ns / n);
+  printf("context arena %.0f bytes/txn average, %" PRIu64 " bytes max\n", total._arena_bytes / n, total._arena_max);
+  printf("%-16s %12s %8s\n", "hook", "cpu ns/txn", "share");
+  for (unsigned idx = 0; idx < HOOKS.size(); ++idx) {
+    std::string name;
+    swoc::bwprint(name, "{}", HOOKS[idx]);
+    printf("%-16s %12.1f %7.1f%%\n", name.c_str(), total._cpu_ns[idx] / n, cpu_ns ? 100.0 * total._cpu_ns[idx] / cpu_ns : 0.0);
+  }
+
+  ts_mock::lifecycle_invoke(TS_LIFECYCLE_SHUTDOWN_HOOK, nullptr);
+  return 0;
+}
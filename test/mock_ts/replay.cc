@@ -0,0 +1,118 @@
+/** @file
+ * Load transactions from replay files for use with the mock TS API.
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <swoc/bwf_base.h>
+
+#include "txn_box/common.h"
+#include "txn_box/yaml_util.h"
+
+#include "replay.h"
+
+using swoc::Errata;
+using swoc::TextView;
+
+namespace
+{
+const std::string SESSIONS_KEY{"sessions"};
+const std::string TRANSACTIONS_KEY{"transactions"};
+const std::string ALL_KEY{"all"};
+const std::string UA_REQ_KEY{"client-request"};
+const std::string UPSTREAM_RSP_KEY{"server-response"};
+const std::string HEADERS_KEY{"headers"};
+const std::string FIELDS_KEY{"fields"};
+const std::string METHOD_KEY{"method"};
+const std::string URL_KEY{"url"};
+const std::string VERSION_KEY{"version"};
+const std::string STATUS_KEY{"status"};
+const std::string REASON_KEY{"reason"};
+
+/// @return The scalar value of @a node or @a dflt if @a node is not a scalar.
+TextView
+scalar(YAML::Node const &node, TextView dflt)
+{
+  return node && node.IsScalar() ? TextView{node.Scalar()} : dflt;
+}
+
+/// Append the fields in @a msg to @a text.
+Errata
+fields_append(std::string &text, YAML::Node const &msg)
+{
+  if (!msg || !msg.IsMap()) {
+    return {};
+  }
+  auto hdr_node = msg[HEADERS_KEY];
+  if (!hdr_node) {
+    return {};
+  }
+  auto fields = hdr_node[FIELDS_KEY];
+  if (!fields) {
+    return {};
+  }
+  if (!fields.IsSequence()) {
+    return Errata(S_ERROR, R"("{}" value at {} is not a list.)", FIELDS_KEY, fields.Mark());
+  }
+  for (auto const &field : fields) {
+    if (!field.IsSequence() || field.size() < 2) {
+      return Errata(S_ERROR, R"(Field at {} is not a list of name and value.)", field.Mark());
+    }
+    text.append(scalar(field[0], "")).append(": ").append(scalar(field[1], "")).append("\r\n");
+  }
+  return {};
+}
+
+} // namespace
+
+Errata
+ts_mock::replay_load(swoc::file::path const &path, std::vector<ReplayTxn> &txns)
+{
+  auto &&[root, errata]{yaml_load(path)};
+  if (!errata.is_ok()) {
+    return std::move(errata);
+  }
+
+  auto ssn_list = root[SESSIONS_KEY];
+  if (!ssn_list || !ssn_list.IsSequence()) {
+    return Errata(S_ERROR, R"(Replay file "{}" does not have a "{}" list.)", path, SESSIONS_KEY);
+  }
+
+  for (auto const &ssn : ssn_list) {
+    auto txn_list = ssn[TRANSACTIONS_KEY];
+    if (!txn_list || !txn_list.IsSequence()) {
+      continue;
+    }
+    for (auto const &txn_node : txn_list) {
+      auto req_node = txn_node[UA_REQ_KEY];
+      if (!req_node) {
+        continue;
+      }
+      auto all_node = txn_node[ALL_KEY];
+      ReplayTxn txn;
+
+      swoc::bwprint(txn._ua_req, "{} {} HTTP/{}\r\n", scalar(req_node[METHOD_KEY], "GET"), scalar(req_node[URL_KEY], "/"),
+                    scalar(req_node[VERSION_KEY], "1.1"));
+      if (auto e = fields_append(txn._ua_req, req_node); !e.is_ok()) {
+        e.note(R"(While loading client request at {} in "{}".)", req_node.Mark(), path);
+        return std::move(e);
+      }
+      fields_append(txn._ua_req, all_node);
+      txn._ua_req += "\r\n";
+
+      if (auto rsp_node = txn_node[UPSTREAM_RSP_KEY]; rsp_node) {
+        swoc::bwprint(txn._upstream_rsp, "HTTP/{} {} {}\r\n", scalar(rsp_node[VERSION_KEY], "1.1"),
+                      scalar(rsp_node[STATUS_KEY], "200"), scalar(rsp_node[REASON_KEY], "OK"));
+        if (auto e = fields_append(txn._upstream_rsp, rsp_node); !e.is_ok()) {
+          e.note(R"(While loading server response at {} in "{}".)", rsp_node.Mark(), path);
+          return std::move(e);
+        }
+        fields_append(txn._upstream_rsp, all_node);
+        txn._upstream_rsp += "\r\n";
+      }
+      txns.emplace_back(std::move(txn));
+    }
+  }
+  return {};
+}
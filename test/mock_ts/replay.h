@@ -0,0 +1,39 @@
+/** @file
+ * Load transactions from replay files for use with the mock TS API.
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <swoc/Errata.h>
+#include <swoc/swoc_file.h>
+
+namespace ts_mock
+{
+/** A transaction from a replay file.
+ *
+ * The headers are HTTP/1 text suitable for @c hdr_assign. The fields from the @c all key of the
+ * transaction are added to both headers.
+ */
+struct ReplayTxn {
+  std::string _ua_req;       ///< Client request.
+  std::string _upstream_rsp; ///< Upstream (server) response, empty if not specified.
+};
+
+/** Load transactions from a replay file.
+ *
+ * @param path Path to the replay file.
+ * @param txns [out] Transactions are appended to this.
+ * @return Errors, if any.
+ *
+ * Only the client request and server response are used, all other keys are ignored. Transactions
+ * without a client request are skipped.
+ */
+swoc::Errata replay_load(swoc::file::path const &path, std::vector<ReplayTxn> &txns);
+
+} // namespace ts_mock
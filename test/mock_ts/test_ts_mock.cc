@@ -0,0 +1,82 @@
+/** @file
+ * Tests for driving the plugin with the mock TS API.
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fstream>
+
+#include "catch.hpp"
+
+#include "txn_box/ts_util.h"
+#include "ts_mock.h"
+
+using swoc::TextView;
+using namespace swoc::literals;
+
+namespace
+{
+constexpr TextView CONFIG = R"(
+txn_box:
+- when: ua-req
+  do:
+  - ua-req-field<X-Path>: ua-req-path
+  - with: ua-req-host
+    select:
+    - match: "one.example"
+      do:
+      - ua-req-field<X-Host>: "one"
+- when: proxy-rsp
+  do:
+  - proxy-rsp-field<X-Path>: ua-req-field<X-Path>
+)";
+
+TextView
+field_value(TSHttpTxn txn, TSReturnCode (*get)(TSHttpTxn, TSMBuffer *, TSMLoc *), TextView name)
+{
+  TSMBuffer buff;
+  TSMLoc loc;
+  if (TS_SUCCESS == get(txn, &buff, &loc)) {
+    return ts::HttpHeader{buff, loc}.field(name).value();
+  }
+  return {};
+}
+
+} // namespace
+
+TEST_CASE("Mock TS global hooks", "[mock]")
+{
+  static constexpr char const *CONFIG_PATH = "test_ts_mock.yaml";
+  {
+    std::ofstream f{CONFIG_PATH};
+    f << CONFIG;
+  }
+  char const *argv[] = {"txn_box.so", CONFIG_PATH};
+  TSPluginInit(2, argv);
+  REQUIRE(ts_mock::diag_error_count_reset() == 0);
+
+  swoc::IPEndpoint remote, local;
+  remote.parse("172.16.1.1:49152");
+  local.parse("10.1.1.1:80");
+  auto ssn = ts_mock::ssn_create(remote, local);
+
+  for (auto [host, expected] : {std::make_tuple("one.example"_tv, "one"_tv), std::make_tuple("two.example"_tv, ""_tv)}) {
+    auto txn = ts_mock::txn_create(ssn);
+    std::string req;
+    swoc::bwprint(req, "GET /alpha/bravo HTTP/1.1\r\nHost: {}\r\n\r\n", host);
+    REQUIRE(ts_mock::hdr_assign(txn, ts_mock::Hdr::UA_REQ, req));
+    REQUIRE(ts_mock::hdr_assign(txn, ts_mock::Hdr::UPSTREAM_RSP, "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n"));
+
+    for (auto id : {TS_HTTP_TXN_START_HOOK, TS_HTTP_READ_REQUEST_HDR_HOOK, TS_HTTP_PRE_REMAP_HOOK, TS_HTTP_POST_REMAP_HOOK,
+                    TS_HTTP_SEND_REQUEST_HDR_HOOK, TS_HTTP_READ_RESPONSE_HDR_HOOK, TS_HTTP_SEND_RESPONSE_HDR_HOOK}) {
+      REQUIRE(ts_mock::hook_invoke(txn, id) == TS_EVENT_HTTP_CONTINUE);
+    }
+
+    REQUIRE(field_value(txn, &TSHttpTxnClientReqGet, "X-Path") == "alpha/bravo");
+    REQUIRE(field_value(txn, &TSHttpTxnClientReqGet, "X-Host") == expected);
+    REQUIRE(field_value(txn, &TSHttpTxnClientRespGet, "X-Path") == "alpha/bravo");
+    ts_mock::txn_close(txn);
+  }
+  ts_mock::ssn_destroy(ssn);
+}
@@ -0,0 +1,1639 @@
+/** @file
+ * Stand in for the Traffic Server plugin API.
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <swoc/TextView.h>
+#include <swoc/swoc_ip.h>
+#include <swoc/bwf_base.h>
+
+#include "ts_mock.h"
+
+using swoc::TextView;
+using namespace swoc::literals;
+
+/* ------------------------------------------------------------------------------------ */
+// Opaque TS API types. These must be in the global namespace to match the forward declarations.
+
+/// Marshal buffer location - header, URL, or field.
+struct tsapi_mloc {
+  virtual ~tsapi_mloc() = default;
+};
+
+/// Mutex - a placeholder, no locking is done.
+struct tsapi_mutex {
+};
+
+/// Continuation.
+struct tsapi_cont {
+  TSEventFunc _f = nullptr; ///< Event handler.
+  TSMutex _mutex = nullptr; ///< Associated mutex.
+  void *_data    = nullptr; ///< Plugin data.
+};
+
+/// Marshal buffer. All locations are owned by the buffer.
+struct tsapi_mbuffer {
+  std::deque<std::unique_ptr<tsapi_mloc>> _locs;
+
+  template <typename T>
+  T *
+  make()
+  {
+    auto loc = new T;
+    _locs.emplace_back(loc);
+    return loc;
+  }
+};
+
+struct tsapi_bufferreader {
+  tsapi_iobuffer *_buff = nullptr; ///< Source buffer.
+  size_t _offset        = 0;       ///< Amount consumed.
+};
+
+struct tsapi_iobuffer {
+  std::string _data; ///< Content.
+  std::vector<std::unique_ptr<tsapi_bufferreader>> _readers;
+};
+
+/// Scheduled task.
+struct tsapi_action {
+  TSCont _cont     = nullptr;
+  bool _periodic_p = false;
+  bool _canceled_p = false;
+};
+
+struct tsapi_thread {
+};
+
+/// Text log - output goes to the diagnostics.
+struct tsapi_textlogobject {
+  std::string _name;
+};
+
+struct tsapi_httpssn {
+  swoc::IPEndpoint _remote; ///< Client address.
+  swoc::IPEndpoint _local;  ///< Inbound proxy address.
+  int _txn_count = 0;       ///< Number of transactions created.
+  std::vector<char const *> _protocols{"http/1.1", "tcp", "ipv4"};
+};
+
+namespace
+{
+struct URL : public tsapi_mloc {
+  std::string _scheme;
+  std::string _host;
+  std::string _path; ///< Without leading slash.
+  std::string _query;
+  std::string _fragment;
+  int _port = 0;
+
+  bool parse(TextView text);
+  std::string print() const;
+};
+
+struct Hdr;
+
+struct Field : public tsapi_mloc {
+  Hdr *_hdr = nullptr;
+  std::string _name;
+  std::string _value;
+};
+
+struct Hdr : public tsapi_mloc {
+  TSHttpType _type = TS_HTTP_TYPE_UNKNOWN;
+  std::string _method;
+  TSHttpStatus _status = TS_HTTP_STATUS_NONE;
+  std::string _reason;
+  URL *_url = nullptr;
+  std::vector<Field *> _fields;
+
+  Field *find(TextView name, size_t start = 0) const;
+  bool parse(tsapi_mbuffer &buff, TextView text);
+  void copy(tsapi_mbuffer &buff, Hdr const &that);
+};
+
+using ConfigValue = std::variant<TSMgmtInt, TSMgmtFloat, std::string>;
+
+} // namespace
+
+struct tsapi_httptxn : public tsapi_cont { // Must be a continuation to match the core.
+  tsapi_httpssn *_ssn = nullptr;
+  tsapi_mbuffer _buff;
+  std::array<Hdr *, 4> _hdrs{{nullptr, nullptr, nullptr, nullptr}};
+  URL *_pristine = nullptr;
+  std::array<void *, 32> _args{};
+  std::map<TSHttpHookID, std::vector<TSCont>> _hooks;
+  TSEvent _reenable = TS_EVENT_HTTP_CONTINUE;
+  TSHttpStatus _status = TS_HTTP_STATUS_NONE;
+  swoc::IPEndpoint _upstream;
+  TSServerState _server_state = TS_SRVSTATE_CONNECTION_ALIVE;
+  std::string _error_body;
+  std::string _cache_url;
+  std::map<int, ConfigValue> _config;
+  std::unique_ptr<TSRemapRequestInfo> _remap_info;
+};
+
+namespace
+{
+/* ------------------------------------------------------------------------------------ */
+// Global state.
+
+std::string Config_Dir{"."};
+bool Diag_Enabled_P = false;
+std::string Diag_Tag;
+std::atomic<unsigned> Error_Count{0};
+tsapi_thread Main_Thread;
+
+std::map<TSHttpHookID, std::vector<TSCont>> Global_Hooks;
+std::map<TSLifecycleHookID, std::vector<TSCont>> Lifecycle_Hooks;
+
+std::mutex Task_Mutex;
+std::list<std::unique_ptr<tsapi_action>> Tasks;
+
+/// Statistics - fixed size so values are never moved.
+struct Stat {
+  std::string _name;
+  std::atomic<TSMgmtInt> _value{0};
+};
+constexpr int MAX_STATS = 4096;
+std::array<Stat, MAX_STATS> Stats;
+std::atomic<int> Stat_Count{0};
+std::mutex Stat_Mutex;
+
+/// User arguments, by type.
+std::mutex Arg_Mutex;
+std::map<int, std::vector<std::string>> Arg_Names;
+
+/// Overridable configuration variables supported by the mock.
+struct ConfigVar {
+  TSOverridableConfigKey _key;
+  TSRecordDataType _type;
+  ConfigValue _default;
+};
+std::map<std::string, ConfigVar, std::less<>> const Config_Vars{
+  {"proxy.config.http.cache.http", {TS_CONFIG_HTTP_CACHE_HTTP, TS_RECORDDATATYPE_INT, TSMgmtInt(1)}},
+  {"proxy.config.url_remap.pristine_host_hdr", {TS_CONFIG_URL_REMAP_PRISTINE_HOST_HDR, TS_RECORDDATATYPE_INT, TSMgmtInt(0)}},
+  {"proxy.config.http.per_server.connection.max", {TS_CONFIG_HTTP_PER_SERVER_CONNECTION_MAX, TS_RECORDDATATYPE_INT, TSMgmtInt(0)}},
+  {"proxy.config.http.background_fill_completed_threshold",
+   {TS_CONFIG_HTTP_BACKGROUND_FILL_COMPLETED_THRESHOLD, TS_RECORDDATATYPE_FLOAT, TSMgmtFloat(0.5)}},
+  {"proxy.config.http.global_user_agent_header", {TS_CONFIG_HTTP_GLOBAL_USER_AGENT_HEADER, TS_RECORDDATATYPE_STRING, std::string{}}},
+};
+
+void
+diag(char const *prefix, char const *fmt, va_list args)
+{
+  if (Diag_Enabled_P) {
+    fprintf(stderr, "%s: ", prefix);
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+  }
+}
+
+/// Convert a hook to the event passed to callbacks.
+TSEvent
+event_for(TSHttpHookID id)
+{
+  switch (id) {
+  case TS_HTTP_TXN_START_HOOK:
+    return TS_EVENT_HTTP_TXN_START;
+  case TS_HTTP_READ_REQUEST_HDR_HOOK:
+    return TS_EVENT_HTTP_READ_REQUEST_HDR;
+  case TS_HTTP_PRE_REMAP_HOOK:
+    return TS_EVENT_HTTP_PRE_REMAP;
+  case TS_HTTP_POST_REMAP_HOOK:
+    return TS_EVENT_HTTP_POST_REMAP;
+  case TS_HTTP_OS_DNS_HOOK:
+    return TS_EVENT_HTTP_OS_DNS;
+  case TS_HTTP_CACHE_LOOKUP_COMPLETE_HOOK:
+    return TS_EVENT_HTTP_CACHE_LOOKUP_COMPLETE;
+  case TS_HTTP_SEND_REQUEST_HDR_HOOK:
+    return TS_EVENT_HTTP_SEND_REQUEST_HDR;
+  case TS_HTTP_READ_RESPONSE_HDR_HOOK:
+    return TS_EVENT_HTTP_READ_RESPONSE_HDR;
+  case TS_HTTP_SEND_RESPONSE_HDR_HOOK:
+    return TS_EVENT_HTTP_SEND_RESPONSE_HDR;
+  case TS_HTTP_TXN_CLOSE_HOOK:
+    return TS_EVENT_HTTP_TXN_CLOSE;
+  default:
+    break;
+  }
+  return TS_EVENT_NONE;
+}
+
+TSEvent
+event_for(TSLifecycleHookID id)
+{
+  switch (id) {
+  case TS_LIFECYCLE_MSG_HOOK:
+    return TS_EVENT_LIFECYCLE_MSG;
+  case TS_LIFECYCLE_SHUTDOWN_HOOK:
+    return TS_EVENT_LIFECYCLE_SHUTDOWN;
+  default:
+    break;
+  }
+  return TS_EVENT_NONE;
+}
+
+template <typename T>
+T *
+loc_cast(TSMLoc loc)
+{
+  return dynamic_cast<T *>(static_cast<tsapi_mloc *>(loc));
+}
+
+/// Return @a text as a C API string.
+char const *
+text_out(std::string const &text, int *length)
+{
+  if (length) {
+    *length = int(text.size());
+  }
+  return text.data();
+}
+
+TSReturnCode
+text_in(std::string &dst, char const *value, int length)
+{
+  dst.assign(value, length < 0 ? strlen(value) : size_t(length));
+  return TS_SUCCESS;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
+bool
+URL::parse(TextView text)
+{
+  text.trim_if(&isspace);
+  if (text.empty()) {
+    return false;
+  }
+  if (auto fragment = text.split_suffix_at('#'); fragment.data()) {
+    _fragment.assign(fragment.data(), fragment.size());
+  }
+  if (auto query = text.split_suffix_at('?'); query.data()) {
+    _query.assign(query.data(), query.size());
+  }
+  if (auto idx = text.find("://"_tv); idx != TextView::npos) {
+    auto scheme = text.prefix(idx);
+    _scheme.assign(scheme.data(), scheme.size());
+    text.remove_prefix(idx + 3);
+    auto authority = text.split_prefix_at('/');
+    if (authority.data() == nullptr) { // no path.
+      authority = text;
+      text.clear();
+    }
+    authority.take_prefix_at('@'); // drop user info, if any.
+    TextView host, port;
+    if (swoc::IPEndpoint::tokenize(authority, &host, &port)) {
+      _host.assign(host.data(), host.size());
+      _port = swoc::svtoi(port);
+    } else {
+      _host.assign(authority.data(), authority.size());
+    }
+  } else {
+    text.ltrim('/');
+  }
+  _path.assign(text.data(), text.size());
+  return true;
+}
+
+std::string
+URL::print() const
+{
+  std::string zret;
+  swoc::bwprint(zret, "{}{}{}/{}{}{}", swoc::bwf::Optional("{}://", _scheme), _host, swoc::bwf::Optional(":{}", _port), _path,
+                swoc::bwf::Optional("?{}", _query), swoc::bwf::Optional("#{}", _fragment));
+  return zret;
+}
+
+Field *
+Hdr::find(TextView name, size_t start) const
+{
+  for (size_t idx = start; idx < _fields.size(); ++idx) {
+    if (0 == strcasecmp(name, _fields[idx]->_name)) {
+      return _fields[idx];
+    }
+  }
+  return nullptr;
+}
+
+bool
+Hdr::parse(tsapi_mbuffer &buff, TextView text)
+{
+  auto line = text.take_prefix_at('\n').rtrim('\r');
+  auto first = line.take_prefix_if(&isspace);
+  auto second = line.ltrim_if(&isspace).take_prefix_if(&isspace);
+  auto third = line.ltrim_if(&isspace);
+
+  _fields.clear();
+  if (first.starts_with_nocase("HTTP/"_tv)) {
+    _type   = TS_HTTP_TYPE_RESPONSE;
+    _status = static_cast<TSHttpStatus>(swoc::svtoi(second));
+    _reason.assign(third.data(), third.size());
+  } else {
+    _type = TS_HTTP_TYPE_REQUEST;
+    _method.assign(first.data(), first.size());
+    _url = buff.make<URL>();
+    if (!_url->parse(second)) {
+      return false;
+    }
+  }
+
+  while (text) {
+    line = text.take_prefix_at('\n').rtrim('\r');
+    if (line.empty()) {
+      break;
+    }
+    auto name = line.take_prefix_at(':').trim_if(&isspace);
+    if (name.empty()) {
+      return false;
+    }
+    auto field  = buff.make<Field>();
+    field->_hdr = this;
+    field->_name.assign(name.data(), name.size());
+    line.trim_if(&isspace);
+    field->_value.assign(line.data(), line.size());
+    _fields.push_back(field);
+  }
+  return true;
+}
+
+void
+Hdr::copy(tsapi_mbuffer &buff, Hdr const &that)
+{
+  _type   = that._type;
+  _method = that._method;
+  _status = that._status;
+  _reason = that._reason;
+  if (that._url) {
+    _url  = buff.make<URL>();
+    *_url = *that._url;
+  }
+  _fields.clear();
+  for (auto f : that._fields) {
+    auto field  = buff.make<Field>();
+    field->_hdr = this;
+    field->_name  = f->_name;
+    field->_value = f->_value;
+    _fields.push_back(field);
+  }
+}
+
+Hdr *&
+hdr_for(TSHttpTxn txn, ts_mock::Hdr which)
+{
+  return txn->_hdrs[static_cast<unsigned>(which)];
+}
+
+TSReturnCode
+hdr_get(TSHttpTxn txn, ts_mock::Hdr which, TSMBuffer *bufp, TSMLoc *locp)
+{
+  if (auto hdr = hdr_for(txn, which); hdr) {
+    *bufp = &txn->_buff;
+    *locp = hdr;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+std::string
+effective_url(TSHttpTxn txn)
+{
+  std::string zret;
+  if (auto hdr = hdr_for(txn, ts_mock::Hdr::UA_REQ); hdr && hdr->_url) {
+    URL url{*hdr->_url};
+    if (url._host.empty()) {
+      if (auto host = hdr->find("Host"); host) {
+        TextView h, p;
+        if (swoc::IPEndpoint::tokenize(host->_value, &h, &p)) {
+          url._host.assign(h.data(), h.size());
+          url._port = swoc::svtoi(p);
+        }
+      }
+      if (url._scheme.empty()) {
+        url._scheme = "http";
+      }
+    }
+    zret = url.print();
+  }
+  return zret;
+}
+
+void
+hooks_invoke(std::vector<TSCont> const &conts, TSHttpTxn txn, TSEvent event)
+{
+  // Callbacks can add hooks, so the list can't be iterated.
+  for (size_t idx = 0; idx < conts.size() && txn->_reenable != TS_EVENT_HTTP_ERROR; ++idx) {
+    auto cont = conts[idx];
+    cont->_f(cont, event, txn);
+  }
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------------------ */
+// Mock control.
+
+namespace ts_mock
+{
+void
+config_dir_set(TextView path)
+{
+  Config_Dir.assign(path.data(), path.size());
+}
+
+void
+diag_enable(bool enable_p, TextView tag)
+{
+  Diag_Enabled_P = enable_p;
+  Diag_Tag.assign(tag.data(), tag.size());
+}
+
+unsigned
+diag_error_count_reset()
+{
+  return Error_Count.exchange(0);
+}
+
+TSHttpSsn
+ssn_create(swoc::IPEndpoint const &remote, swoc::IPEndpoint const &local)
+{
+  auto ssn     = new tsapi_httpssn;
+  ssn->_remote = remote;
+  ssn->_local  = local;
+  return ssn;
+}
+
+void
+ssn_destroy(TSHttpSsn ssn)
+{
+  delete ssn;
+}
+
+TSHttpTxn
+txn_create(TSHttpSsn ssn)
+{
+  auto txn    = new tsapi_httptxn;
+  txn->_mutex = TSMutexCreate();
+  txn->_ssn   = ssn;
+  ++ssn->_txn_count;
+  return txn;
+}
+
+void
+txn_close(TSHttpTxn txn)
+{
+  hook_invoke(txn, TS_HTTP_TXN_CLOSE_HOOK);
+  delete txn->_mutex;
+  delete txn;
+}
+
+bool
+hdr_assign(TSHttpTxn txn, Hdr which, TextView text)
+{
+  auto hdr = txn->_buff.make<::Hdr>();
+  if (!hdr->parse(txn->_buff, text)) {
+    return false;
+  }
+  if (which == Hdr::UA_REQ && hdr->_url) {
+    txn->_pristine  = txn->_buff.make<URL>();
+    *txn->_pristine = *hdr->_url;
+  }
+  hdr_for(txn, which) = hdr;
+  return true;
+}
+
+TSEvent
+hook_invoke(TSHttpTxn txn, TSHttpHookID id)
+{
+  // Make the headers available as the transaction progresses.
+  if (id == TS_HTTP_SEND_REQUEST_HDR_HOOK && !hdr_for(txn, Hdr::PROXY_REQ)) {
+    if (auto ua_req = hdr_for(txn, Hdr::UA_REQ); ua_req) {
+      auto hdr = txn->_buff.make<::Hdr>();
+      hdr->copy(txn->_buff, *ua_req);
+      hdr_for(txn, Hdr::PROXY_REQ) = hdr;
+    }
+  } else if (id == TS_HTTP_SEND_RESPONSE_HDR_HOOK && !hdr_for(txn, Hdr::PROXY_RSP)) {
+    auto hdr = txn->_buff.make<::Hdr>();
+    if (auto ursp = hdr_for(txn, Hdr::UPSTREAM_RSP); ursp) {
+      hdr->copy(txn->_buff, *ursp);
+    } else {
+      hdr->_type   = TS_HTTP_TYPE_RESPONSE;
+      hdr->_status = txn->_status != TS_HTTP_STATUS_NONE ? txn->_status : TS_HTTP_STATUS_OK;
+    }
+    hdr_for(txn, Hdr::PROXY_RSP) = hdr;
+  }
+
+  txn->_reenable = TS_EVENT_HTTP_CONTINUE;
+  auto event     = event_for(id);
+  if (auto spot = Global_Hooks.find(id); spot != Global_Hooks.end()) {
+    hooks_invoke(spot->second, txn, event);
+  }
+  if (auto spot = txn->_hooks.find(id); spot != txn->_hooks.end()) {
+    hooks_invoke(spot->second, txn, event);
+  }
+  return txn->_reenable;
+}
+
+TSRemapRequestInfo *
+remap_info(TSHttpTxn txn, TextView from, TextView to)
+{
+  auto ua_req = hdr_for(txn, Hdr::UA_REQ);
+  if (!ua_req) {
+    return nullptr;
+  }
+  auto from_url = txn->_buff.make<URL>();
+  auto to_url   = txn->_buff.make<URL>();
+  from_url->parse(from);
+  to_url->parse(to);
+
+  txn->_remap_info.reset(new TSRemapRequestInfo{});
+  auto rri          = txn->_remap_info.get();
+  rri->requestBufp  = &txn->_buff;
+  rri->requestHdrp  = ua_req;
+  rri->requestUrl   = ua_req->_url;
+  rri->mapFromUrl   = from_url;
+  rri->mapToUrl     = to_url;
+  return rri;
+}
+
+void
+lifecycle_invoke(TSLifecycleHookID id, void *data)
+{
+  if (auto spot = Lifecycle_Hooks.find(id); spot != Lifecycle_Hooks.end()) {
+    for (auto cont : spot->second) {
+      cont->_f(cont, event_for(id), data);
+    }
+  }
+}
+
+unsigned
+task_run()
+{
+  std::list<std::unique_ptr<tsapi_action>> tasks;
+  {
+    std::lock_guard lock(Task_Mutex);
+    tasks.swap(Tasks);
+  }
+
+  unsigned zret = 0;
+  for (auto spot = tasks.begin(); spot != tasks.end();) {
+    auto action = spot->get();
+    if (!action->_canceled_p) {
+      ++zret;
+      action->_cont->_f(action->_cont, TS_EVENT_TIMEOUT, action);
+    }
+    // The task may have canceled itself, and one shot tasks are done.
+    if (action->_canceled_p || !action->_periodic_p) {
+      spot = tasks.erase(spot);
+    } else {
+      ++spot;
+    }
+  }
+
+  std::lock_guard lock(Task_Mutex);
+  Tasks.splice(Tasks.begin(), tasks);
+  return zret;
+}
+
+TSHttpStatus
+txn_status(TSHttpTxn txn)
+{
+  return txn->_status;
+}
+
+swoc::IPEndpoint
+txn_upstream_addr(TSHttpTxn txn)
+{
+  return txn->_upstream;
+}
+
+} // namespace ts_mock
+
+/* ------------------------------------------------------------------------------------ */
+// TS API implementation.
+
+int
+TSIsDebugTagSet(const char *t)
+{
+  return Diag_Enabled_P && (Diag_Tag.empty() || Diag_Tag == t);
+}
+
+void
+TSDebug(const char *tag, const char *format_str, ...)
+{
+  if (TSIsDebugTagSet(tag)) {
+    va_list args;
+    va_start(args, format_str);
+    diag(tag, format_str, args);
+    va_end(args);
+  }
+}
+
+void
+TSNote(const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  diag("NOTE", fmt, args);
+  va_end(args);
+}
+
+void
+TSWarning(const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  diag("WARNING", fmt, args);
+  va_end(args);
+}
+
+void
+TSError(const char *fmt, ...)
+{
+  ++Error_Count;
+  va_list args;
+  va_start(args, fmt);
+  diag("ERROR", fmt, args);
+  va_end(args);
+}
+
+TSReturnCode
+TSTextLogObjectCreate(const char *filename, int, TSTextLogObject *new_log_obj)
+{
+  auto log     = new tsapi_textlogobject;
+  log->_name   = filename;
+  *new_log_obj = log;
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSTextLogObjectWrite(TSTextLogObject the_object, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  diag(the_object->_name.c_str(), format, args);
+  va_end(args);
+  return TS_SUCCESS;
+}
+
+void *
+_TSmalloc(size_t size, const char *)
+{
+  return malloc(size);
+}
+
+void
+_TSfree(void *ptr)
+{
+  free(ptr);
+}
+
+const char *
+TSConfigDirGet(void)
+{
+  return Config_Dir.c_str();
+}
+
+TSReturnCode
+TSPluginRegister(const TSPluginRegistrationInfo *)
+{
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSPluginDSOReloadEnable(int)
+{
+  return TS_SUCCESS;
+}
+
+void
+TSLifecycleHookAdd(TSLifecycleHookID id, TSCont contp)
+{
+  Lifecycle_Hooks[id].push_back(contp);
+}
+
+void
+TSHttpHookAdd(TSHttpHookID id, TSCont contp)
+{
+  Global_Hooks[id].push_back(contp);
+}
+
+void
+TSHttpTxnHookAdd(TSHttpTxn txnp, TSHttpHookID id, TSCont contp)
+{
+  txnp->_hooks[id].push_back(contp);
+}
+
+void
+TSHttpTxnReenable(TSHttpTxn txnp, TSEvent event)
+{
+  txnp->_reenable = event;
+}
+
+// --- Continuations and tasks.
+
+TSCont
+TSContCreate(TSEventFunc funcp, TSMutex mutexp)
+{
+  auto cont    = new tsapi_cont;
+  cont->_f     = funcp;
+  cont->_mutex = mutexp;
+  return cont;
+}
+
+void
+TSContDestroy(TSCont contp)
+{
+  // Scheduled tasks for this continuation can't be invoked any more.
+  std::lock_guard lock(Task_Mutex);
+  for (auto &action : Tasks) {
+    if (action->_cont == contp) {
+      action->_canceled_p = true;
+    }
+  }
+  delete contp;
+}
+
+void
+TSContDataSet(TSCont contp, void *data)
+{
+  contp->_data = data;
+}
+
+void *
+TSContDataGet(TSCont contp)
+{
+  return contp->_data;
+}
+
+TSMutex
+TSContMutexGet(TSCont contp)
+{
+  return contp->_mutex;
+}
+
+int
+TSContCall(TSCont contp, TSEvent event, void *edata)
+{
+  return contp->_f(contp, event, edata);
+}
+
+TSAction
+TSContScheduleOnPool(TSCont contp, TSHRTime, TSThreadPool)
+{
+  auto action   = new tsapi_action;
+  action->_cont = contp;
+  std::lock_guard lock(Task_Mutex);
+  Tasks.emplace_back(action);
+  return action;
+}
+
+TSAction
+TSContScheduleEveryOnPool(TSCont contp, TSHRTime, TSThreadPool)
+{
+  auto action         = new tsapi_action;
+  action->_cont       = contp;
+  action->_periodic_p = true;
+  std::lock_guard lock(Task_Mutex);
+  Tasks.emplace_back(action);
+  return action;
+}
+
+void
+TSActionCancel(TSAction actionp)
+{
+  actionp->_canceled_p = true;
+}
+
+TSMutex
+TSMutexCreate(void)
+{
+  return new tsapi_mutex;
+}
+
+TSReturnCode
+TSMutexLockTry(TSMutex)
+{
+  return TS_SUCCESS;
+}
+
+void
+TSMutexUnlock(TSMutex)
+{
+}
+
+TSThread
+TSThreadSelf(void)
+{
+  return &Main_Thread;
+}
+
+// --- Statistics.
+
+int
+TSStatCreate(const char *the_name, TSRecordDataType, TSStatPersistence, TSStatSync)
+{
+  std::lock_guard lock(Stat_Mutex);
+  int idx = Stat_Count;
+  if (idx >= MAX_STATS) {
+    return TS_ERROR;
+  }
+  Stats[idx]._name = the_name;
+  Stats[idx]._value = 0;
+  ++Stat_Count;
+  return idx;
+}
+
+void
+TSStatIntIncrement(int the_stat, TSMgmtInt amount)
+{
+  Stats[the_stat]._value += amount;
+}
+
+void
+TSStatIntSet(int the_stat, TSMgmtInt value)
+{
+  Stats[the_stat]._value = value;
+}
+
+TSMgmtInt
+TSStatIntGet(int the_stat)
+{
+  return Stats[the_stat]._value;
+}
+
+void
+TSRecordDump(int rec_type, TSRecordDumpCb callback, void *edata)
+{
+  if (!(rec_type & TS_RECORDTYPE_PLUGIN)) {
+    return;
+  }
+  for (int idx = 0, n = Stat_Count; idx < n; ++idx) {
+    TSRecordData datum;
+    datum.rec_int = Stats[idx]._value;
+    callback(TS_RECORDTYPE_PLUGIN, edata, 1, Stats[idx]._name.c_str(), TS_RECORDDATATYPE_INT, &datum);
+  }
+}
+
+TSReturnCode
+TSStatFindName(const char *name, int *idp)
+{
+  std::lock_guard lock(Stat_Mutex);
+  for (int idx = 0, n = Stat_Count; idx < n; ++idx) {
+    if (Stats[idx]._name == name) {
+      *idp = idx;
+      return TS_SUCCESS;
+    }
+  }
+  return TS_ERROR;
+}
+
+// --- User arguments.
+
+TSReturnCode
+TSUserArgIndexReserve(TSUserArgType type, const char *name, const char *, int *arg_idx)
+{
+  std::lock_guard lock(Arg_Mutex);
+  auto &names = Arg_Names[type];
+  if (names.size() >= std::tuple_size<decltype(tsapi_httptxn::_args)>::value) {
+    return TS_ERROR;
+  }
+  *arg_idx = names.size();
+  names.emplace_back(name);
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSUserArgIndexNameLookup(TSUserArgType type, const char *name, int *arg_idx, const char **description)
+{
+  std::lock_guard lock(Arg_Mutex);
+  auto &names = Arg_Names[type];
+  for (size_t idx = 0; idx < names.size(); ++idx) {
+    if (names[idx] == name) {
+      *arg_idx = idx;
+      if (description) {
+        *description = names[idx].c_str();
+      }
+      return TS_SUCCESS;
+    }
+  }
+  return TS_ERROR;
+}
+
+void
+TSUserArgSet(void *data, int arg_idx, void *arg)
+{
+  static_cast<TSHttpTxn>(data)->_args[arg_idx] = arg;
+}
+
+void *
+TSUserArgGet(void *data, int arg_idx)
+{
+  return static_cast<TSHttpTxn>(data)->_args[arg_idx];
+}
+
+// --- Transactions and sessions.
+
+TSReturnCode
+TSHttpTxnClientReqGet(TSHttpTxn txnp, TSMBuffer *bufp, TSMLoc *offset)
+{
+  return hdr_get(txnp, ts_mock::Hdr::UA_REQ, bufp, offset);
+}
+
+TSReturnCode
+TSHttpTxnServerReqGet(TSHttpTxn txnp, TSMBuffer *bufp, TSMLoc *offset)
+{
+  return hdr_get(txnp, ts_mock::Hdr::PROXY_REQ, bufp, offset);
+}
+
+TSReturnCode
+TSHttpTxnServerRespGet(TSHttpTxn txnp, TSMBuffer *bufp, TSMLoc *offset)
+{
+  return hdr_get(txnp, ts_mock::Hdr::UPSTREAM_RSP, bufp, offset);
+}
+
+TSReturnCode
+TSHttpTxnClientRespGet(TSHttpTxn txnp, TSMBuffer *bufp, TSMLoc *offset)
+{
+  return hdr_get(txnp, ts_mock::Hdr::PROXY_RSP, bufp, offset);
+}
+
+TSReturnCode
+TSHttpTxnPristineUrlGet(TSHttpTxn txnp, TSMBuffer *bufp, TSMLoc *url_loc)
+{
+  if (txnp->_pristine) {
+    *bufp    = &txnp->_buff;
+    *url_loc = txnp->_pristine;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+char *
+TSHttpTxnEffectiveUrlStringGet(TSHttpTxn txnp, int *length)
+{
+  auto url  = effective_url(txnp);
+  auto zret = static_cast<char *>(TSmalloc(url.size() + 1));
+  memcpy(zret, url.c_str(), url.size() + 1);
+  *length = url.size();
+  return zret;
+}
+
+TSHttpSsn
+TSHttpTxnSsnGet(TSHttpTxn txnp)
+{
+  return txnp->_ssn;
+}
+
+void
+TSHttpTxnStatusSet(TSHttpTxn txnp, TSHttpStatus status)
+{
+  txnp->_status = status;
+}
+
+void
+TSHttpTxnErrorBodySet(TSHttpTxn txnp, char *buf, size_t buflength, char *mimetype)
+{
+  txnp->_error_body.assign(buf, buflength);
+  TSfree(buf);
+  TSfree(mimetype);
+}
+
+void
+TSHttpTxnDebugSet(TSHttpTxn, int)
+{
+}
+
+int
+TSHttpTxnIsInternal(TSHttpTxn)
+{
+  return 0;
+}
+
+TSReturnCode
+TSHttpTxnServerAddrSet(TSHttpTxn txnp, struct sockaddr const *addr)
+{
+  txnp->_upstream.assign(addr);
+  return TS_SUCCESS;
+}
+
+struct sockaddr const *
+TSHttpTxnServerAddrGet(TSHttpTxn txnp)
+{
+  return txnp->_upstream.is_valid() ? &txnp->_upstream.sa : nullptr;
+}
+
+struct sockaddr const *
+TSHttpTxnOutgoingAddrGet(TSHttpTxn)
+{
+  return nullptr;
+}
+
+TSServerState
+TSHttpTxnServerStateGet(TSHttpTxn txnp)
+{
+  return txnp->_server_state;
+}
+
+TSReturnCode
+TSHttpTxnClientFdGet(TSHttpTxn, int *)
+{
+  return TS_ERROR;
+}
+
+TSReturnCode
+TSCacheUrlSet(TSHttpTxn txnp, const char *url, int length)
+{
+  txnp->_cache_url.assign(url, length);
+  return TS_SUCCESS;
+}
+
+#if TS_VERSION_MAJOR >= 10
+int
+TSHttpTxnServerSsnTransactionCount(TSHttpTxn)
+{
+  return 0;
+}
+#endif
+
+TSReturnCode
+TSHttpTxnServerProtocolStackGet(TSHttpTxn, int, const char **, int *actual)
+{
+  *actual = 0;
+  return TS_SUCCESS;
+}
+
+const char *
+TSHttpTxnServerProtocolStackContains(TSHttpTxn, char const *)
+{
+  return nullptr;
+}
+
+TSReturnCode
+TSHttpTxnConfigFind(const char *name, int length, TSOverridableConfigKey *conf, TSRecordDataType *type)
+{
+  if (auto spot = Config_Vars.find(std::string_view{name, length < 0 ? strlen(name) : size_t(length)}); spot != Config_Vars.end()) {
+    *conf = spot->second._key;
+    *type = spot->second._type;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+namespace
+{
+ConfigValue const *
+config_value(TSHttpTxn txnp, TSOverridableConfigKey conf)
+{
+  if (auto spot = txnp->_config.find(conf); spot != txnp->_config.end()) {
+    return &spot->second;
+  }
+  for (auto const &[name, var] : Config_Vars) {
+    if (var._key == conf) {
+      return &var._default;
+    }
+  }
+  return nullptr;
+}
+
+template <typename T>
+TSReturnCode
+config_get(TSHttpTxn txnp, TSOverridableConfigKey conf, T *value)
+{
+  if (auto v = config_value(txnp, conf); v && std::holds_alternative<T>(*v)) {
+    *value = std::get<T>(*v);
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+} // namespace
+
+TSReturnCode
+TSHttpTxnConfigIntSet(TSHttpTxn txnp, TSOverridableConfigKey conf, TSMgmtInt value)
+{
+  txnp->_config[conf] = value;
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSHttpTxnConfigIntGet(TSHttpTxn txnp, TSOverridableConfigKey conf, TSMgmtInt *value)
+{
+  return config_get(txnp, conf, value);
+}
+
+TSReturnCode
+TSHttpTxnConfigFloatSet(TSHttpTxn txnp, TSOverridableConfigKey conf, TSMgmtFloat value)
+{
+  txnp->_config[conf] = value;
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSHttpTxnConfigFloatGet(TSHttpTxn txnp, TSOverridableConfigKey conf, TSMgmtFloat *value)
+{
+  return config_get(txnp, conf, value);
+}
+
+TSReturnCode
+TSHttpTxnConfigStringSet(TSHttpTxn txnp, TSOverridableConfigKey conf, const char *value, int length)
+{
+  txnp->_config[conf] = std::string(value, length < 0 ? strlen(value) : size_t(length));
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSHttpTxnConfigStringGet(TSHttpTxn txnp, TSOverridableConfigKey conf, const char **value, int *length)
+{
+  if (auto v = config_value(txnp, conf); v && std::holds_alternative<std::string>(*v)) {
+    *value = text_out(std::get<std::string>(*v), length);
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+TSReturnCode
+TSHttpSsnClientProtocolStackGet(TSHttpSsn ssnp, int count, const char **result, int *actual)
+{
+  int n = std::min<int>(count, ssnp->_protocols.size());
+  std::copy_n(ssnp->_protocols.begin(), n, result);
+  *actual = n;
+  return TS_SUCCESS;
+}
+
+const char *
+TSHttpSsnClientProtocolStackContains(TSHttpSsn ssnp, char const *tag)
+{
+  TextView prefix{tag, strlen(tag)};
+  for (auto p : ssnp->_protocols) {
+    if (TextView{p, strlen(p)}.starts_with(prefix)) {
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+struct sockaddr const *
+TSHttpSsnClientAddrGet(TSHttpSsn ssnp)
+{
+  return &ssnp->_remote.sa;
+}
+
+struct sockaddr const *
+TSHttpSsnIncomingAddrGet(TSHttpSsn ssnp)
+{
+  return &ssnp->_local.sa;
+}
+
+TSVConn
+TSHttpSsnClientVConnGet(TSHttpSsn)
+{
+  return nullptr;
+}
+
+int
+TSHttpSsnTransactionCount(TSHttpSsn ssnp)
+{
+  return ssnp->_txn_count;
+}
+
+TSSslConnection
+TSVConnSslConnectionGet(TSVConn)
+{
+  return nullptr;
+}
+
+// --- Headers.
+
+TSReturnCode
+TSHandleMLocRelease(TSMBuffer, TSMLoc, TSMLoc)
+{
+  return TS_SUCCESS; // Locations are owned by the buffer.
+}
+
+TSReturnCode
+TSHttpHdrUrlGet(TSMBuffer, TSMLoc offset, TSMLoc *locp)
+{
+  if (auto hdr = loc_cast<Hdr>(offset); hdr && hdr->_url) {
+    *locp = hdr->_url;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+TSReturnCode
+TSHttpHdrUrlSet(TSMBuffer, TSMLoc offset, TSMLoc url)
+{
+  auto hdr = loc_cast<Hdr>(offset);
+  auto u   = loc_cast<URL>(url);
+  if (hdr && u) {
+    hdr->_url = u;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+const char *
+TSHttpHdrMethodGet(TSMBuffer, TSMLoc offset, int *length)
+{
+  if (auto hdr = loc_cast<Hdr>(offset); hdr) {
+    return text_out(hdr->_method, length);
+  }
+  *length = 0;
+  return nullptr;
+}
+
+TSHttpStatus
+TSHttpHdrStatusGet(TSMBuffer, TSMLoc offset)
+{
+  auto hdr = loc_cast<Hdr>(offset);
+  return hdr ? hdr->_status : TS_HTTP_STATUS_NONE;
+}
+
+TSReturnCode
+TSHttpHdrStatusSet(TSMBuffer, TSMLoc offset, TSHttpStatus status)
+{
+  if (auto hdr = loc_cast<Hdr>(offset); hdr) {
+    hdr->_status = status;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+const char *
+TSHttpHdrReasonGet(TSMBuffer, TSMLoc offset, int *length)
+{
+  if (auto hdr = loc_cast<Hdr>(offset); hdr) {
+    return text_out(hdr->_reason, length);
+  }
+  *length = 0;
+  return nullptr;
+}
+
+TSReturnCode
+TSHttpHdrReasonSet(TSMBuffer, TSMLoc offset, const char *value, int length)
+{
+  if (auto hdr = loc_cast<Hdr>(offset); hdr) {
+    return text_in(hdr->_reason, value, length);
+  }
+  return TS_ERROR;
+}
+
+TSMLoc
+TSMimeHdrFieldFind(TSMBuffer, TSMLoc hdr, const char *name, int length)
+{
+  if (auto h = loc_cast<Hdr>(hdr); h) {
+    return h->find(TextView{name, length < 0 ? strlen(name) : size_t(length)});
+  }
+  return TS_NULL_MLOC;
+}
+
+TSMLoc
+TSMimeHdrFieldNextDup(TSMBuffer, TSMLoc hdr, TSMLoc field)
+{
+  auto h = loc_cast<Hdr>(hdr);
+  auto f = loc_cast<Field>(field);
+  if (h && f) {
+    if (auto spot = std::find(h->_fields.begin(), h->_fields.end(), f); spot != h->_fields.end()) {
+      return h->find(f->_name, (spot - h->_fields.begin()) + 1);
+    }
+  }
+  return TS_NULL_MLOC;
+}
+
+const char *
+TSMimeHdrFieldNameGet(TSMBuffer, TSMLoc, TSMLoc field, int *length)
+{
+  if (auto f = loc_cast<Field>(field); f) {
+    return text_out(f->_name, length);
+  }
+  *length = 0;
+  return nullptr;
+}
+
+const char *
+TSMimeHdrFieldValueStringGet(TSMBuffer, TSMLoc, TSMLoc field, int, int *value_len_ptr)
+{
+  if (auto f = loc_cast<Field>(field); f) {
+    return text_out(f->_value, value_len_ptr);
+  }
+  *value_len_ptr = 0;
+  return nullptr;
+}
+
+TSReturnCode
+TSMimeHdrFieldValueStringSet(TSMBuffer, TSMLoc, TSMLoc field, int, const char *value, int length)
+{
+  if (auto f = loc_cast<Field>(field); f) {
+    return text_in(f->_value, value, length);
+  }
+  return TS_ERROR;
+}
+
+TSReturnCode
+TSMimeHdrFieldDestroy(TSMBuffer, TSMLoc hdr, TSMLoc field)
+{
+  auto h = loc_cast<Hdr>(hdr);
+  auto f = loc_cast<Field>(field);
+  if (h && f) {
+    if (auto spot = std::find(h->_fields.begin(), h->_fields.end(), f); spot != h->_fields.end()) {
+      h->_fields.erase(spot);
+    }
+    f->_hdr = nullptr;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+TSReturnCode
+TSMimeHdrFieldCreateNamed(TSMBuffer bufp, TSMLoc, const char *name, int name_len, TSMLoc *locp)
+{
+  auto f = bufp->make<Field>();
+  text_in(f->_name, name, name_len);
+  *locp = f;
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSMimeHdrFieldAppend(TSMBuffer, TSMLoc hdr, TSMLoc field)
+{
+  auto h = loc_cast<Hdr>(hdr);
+  auto f = loc_cast<Field>(field);
+  if (h && f && f->_hdr == nullptr) {
+    f->_hdr = h;
+    h->_fields.push_back(f);
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+// --- URLs.
+
+TSReturnCode
+TSUrlCreate(TSMBuffer bufp, TSMLoc *locp)
+{
+  *locp = bufp->make<URL>();
+  return TS_SUCCESS;
+}
+
+TSParseResult
+TSUrlParse(TSMBuffer, TSMLoc offset, const char **start, const char *end)
+{
+  if (auto url = loc_cast<URL>(offset); url && url->parse(TextView{*start, end})) {
+    *start = end;
+    return TS_PARSE_DONE;
+  }
+  return TS_PARSE_ERROR;
+}
+
+void
+TSUrlPrint(TSMBuffer, TSMLoc offset, TSIOBuffer iobufp)
+{
+  if (auto url = loc_cast<URL>(offset); url) {
+    iobufp->_data += url->print();
+  }
+}
+
+#define MOCK_URL_TEXT_ACCESSOR(NAME, MEMBER)                                    \
+  const char *TSUrl##NAME##Get(TSMBuffer, TSMLoc offset, int *length)           \
+  {                                                                             \
+    if (auto url = loc_cast<URL>(offset); url) {                                \
+      return text_out(url->MEMBER, length);                                     \
+    }                                                                           \
+    *length = 0;                                                                \
+    return nullptr;                                                             \
+  }                                                                             \
+  TSReturnCode TSUrl##NAME##Set(TSMBuffer, TSMLoc offset, const char *value, int length) \
+  {                                                                             \
+    if (auto url = loc_cast<URL>(offset); url) {                                \
+      return text_in(url->MEMBER, value, length);                               \
+    }                                                                           \
+    return TS_ERROR;                                                            \
+  }
+
+MOCK_URL_TEXT_ACCESSOR(Scheme, _scheme)
+MOCK_URL_TEXT_ACCESSOR(Host, _host)
+MOCK_URL_TEXT_ACCESSOR(Path, _path)
+MOCK_URL_TEXT_ACCESSOR(HttpQuery, _query)
+MOCK_URL_TEXT_ACCESSOR(HttpFragment, _fragment)
+
+#undef MOCK_URL_TEXT_ACCESSOR
+
+int
+TSUrlPortGet(TSMBuffer, TSMLoc offset)
+{
+  if (auto url = loc_cast<URL>(offset); url) {
+    if (url->_port) {
+      return url->_port;
+    }
+    return 0 == strcasecmp(url->_scheme, "https") ? 443 : 80;
+  }
+  return 0;
+}
+
+TSReturnCode
+TSUrlPortSet(TSMBuffer, TSMLoc offset, int port)
+{
+  if (auto url = loc_cast<URL>(offset); url) {
+    url->_port = port;
+    return TS_SUCCESS;
+  }
+  return TS_ERROR;
+}
+
+TSReturnCode
+TSStringPercentEncode(const char *str, int str_len, char *dst, size_t dst_size, size_t *length, const unsigned char *map)
+{
+  static constexpr char HEX[] = "0123456789ABCDEF";
+  size_t n = 0;
+  for (int idx = 0; idx < str_len; ++idx) {
+    unsigned char c = str[idx];
+    bool escape_p   = map ? (map[c / 8] & (0x80 >> (c % 8))) : (c <= ' ' || c >= 0x7F || strchr("\"#%<>[\\]^`{|}", c));
+    if (escape_p) {
+      if (n + 3 >= dst_size) {
+        return TS_ERROR;
+      }
+      dst[n++] = '%';
+      dst[n++] = HEX[c >> 4];
+      dst[n++] = HEX[c & 0xF];
+    } else {
+      if (n + 1 >= dst_size) {
+        return TS_ERROR;
+      }
+      dst[n++] = c;
+    }
+  }
+  dst[n]  = '\0';
+  *length = n;
+  return TS_SUCCESS;
+}
+
+TSReturnCode
+TSStringPercentDecode(const char *str, size_t str_len, char *dst, size_t dst_size, size_t *length)
+{
+  size_t n = 0;
+  for (size_t idx = 0; idx < str_len && n + 1 < dst_size; ++idx) {
+    if (str[idx] == '%' && idx + 2 < str_len && isxdigit(str[idx + 1]) && isxdigit(str[idx + 2])) {
+      char hex[3] = {str[idx + 1], str[idx + 2], 0};
+      dst[n++]    = static_cast<char>(strtol(hex, nullptr, 16));
+      idx += 2;
+    } else {
+      dst[n++] = str[idx];
+    }
+  }
+  dst[n]  = '\0';
+  *length = n;
+  return TS_SUCCESS;
+}
+
+// --- IO buffers. Only enough to support URL printing.
+
+TSIOBuffer
+TSIOBufferCreate(void)
+{
+  return new tsapi_iobuffer;
+}
+
+TSIOBuffer
+TSIOBufferSizedCreate(TSIOBufferSizeIndex)
+{
+  return new tsapi_iobuffer;
+}
+
+void
+TSIOBufferDestroy(TSIOBuffer bufp)
+{
+  delete bufp;
+}
+
+int64_t
+TSIOBufferWrite(TSIOBuffer bufp, const void *buf, int64_t length)
+{
+  bufp->_data.append(static_cast<char const *>(buf), length);
+  return length;
+}
+
+TSIOBufferReader
+TSIOBufferReaderAlloc(TSIOBuffer bufp)
+{
+  auto reader   = new tsapi_bufferreader;
+  reader->_buff = bufp;
+  bufp->_readers.emplace_back(reader);
+  return reader;
+}
+
+TSIOBufferBlock
+TSIOBufferReaderStart(TSIOBufferReader readerp)
+{
+  // The entire buffer is a single block, which is identified by the reader.
+  return reinterpret_cast<TSIOBufferBlock>(readerp);
+}
+
+const char *
+TSIOBufferBlockReadStart(TSIOBufferBlock, TSIOBufferReader readerp, int64_t *avail)
+{
+  *avail = readerp->_buff->_data.size() - readerp->_offset;
+  return readerp->_buff->_data.data() + readerp->_offset;
+}
+
+int64_t
+TSIOBufferReaderAvail(TSIOBufferReader readerp)
+{
+  return readerp->_buff->_data.size() - readerp->_offset;
+}
+
+void
+TSIOBufferReaderConsume(TSIOBufferReader readerp, int64_t nbytes)
+{
+  readerp->_offset = std::min<size_t>(readerp->_offset + nbytes, readerp->_buff->_data.size());
+}
+
+// --- Transforms and VIOs are not supported.
+
+TSVConn
+TSTransformCreate(TSEventFunc event_funcp, TSHttpTxn)
+{
+  return TSContCreate(event_funcp, nullptr);
+}
+
+TSVConn
+TSTransformOutputVConnGet(TSVConn)
+{
+  return nullptr;
+}
+
+TSVIO
+TSVConnWrite(TSVConn, TSCont, TSIOBufferReader, int64_t)
+{
+  return nullptr;
+}
+
+TSVIO
+TSVConnWriteVIOGet(TSVConn)
+{
+  return nullptr;
+}
+
+int
+TSVConnClosedGet(TSVConn)
+{
+  return 1;
+}
+
+void
+TSVConnShutdown(TSVConn, int, int)
+{
+}
+
+TSCont
+TSVIOContGet(TSVIO)
+{
+  return nullptr;
+}
+
+int64_t
+TSVIONTodoGet(TSVIO)
+{
+  return 0;
+}
+
+int64_t
+TSVIONDoneGet(TSVIO)
+{
+  return 0;
+}
+
+void
+TSVIONDoneSet(TSVIO, int64_t)
+{
+}
+
+TSIOBufferReader
+TSVIOReaderGet(TSVIO)
+{
+  return nullptr;
+}
+
+void
+TSVIOReenable(TSVIO)
+{
+}
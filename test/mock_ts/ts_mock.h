@@ -0,0 +1,143 @@
+/** @file
+ * Stand in for the Traffic Server plugin API.
+ *
+ * This provides an in-process implementation of the subset of the TS C API used by the plugin so
+ * that configurations can be loaded and transaction hooks invoked without @c traffic_server. The
+ * TS API functions are implemented directly, this header declares the additional functions used to
+ * drive the mock - creating sessions and transactions, setting headers, and invoking hooks.
+ *
+ * Limitations -
+ * - Transforms, VIOs, and SSL are stubs that fail or do nothing.
+ * - Mutexes do not lock. Hooks for a transaction must be invoked from a single thread, although
+ *   different transactions can be driven from different threads.
+ * - Scheduled tasks are run only when @c task_run is called, periodic tasks run once per call.
+ *
+ * Copyright 2020, Verizon Media
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <swoc/TextView.h>
+#include <swoc/swoc_ip.h>
+
+#include <ts/ts.h>
+#include <ts/remap.h>
+
+namespace ts_mock
+{
+/// Transaction headers.
+enum class Hdr {
+  UA_REQ,       ///< Client request.
+  PROXY_REQ,    ///< Request sent upstream.
+  UPSTREAM_RSP, ///< Response from upstream.
+  PROXY_RSP     ///< Response sent to the client.
+};
+
+/** Set the configuration directory.
+ *
+ * @param path Directory path.
+ *
+ * This is the value returned by @c TSConfigDirGet, and is used to resolve relative file paths.
+ */
+void config_dir_set(swoc::TextView path);
+
+/** Enable or disable diagnostic output.
+ *
+ * @param enable_p Print diagnostics if @c true.
+ * @param tag Debug tag to enable, all tags if empty.
+ *
+ * Errors, warnings, and notes are always recorded, but printed to @c stderr only if enabled.
+ */
+void diag_enable(bool enable_p, swoc::TextView tag = {});
+
+/// @return The number of errors reported via @c TSError since the last call.
+unsigned diag_error_count_reset();
+
+/** Create a session.
+ *
+ * @param remote Client address.
+ * @param local Inbound (proxy) address.
+ * @return A new session.
+ */
+TSHttpSsn ssn_create(swoc::IPEndpoint const &remote, swoc::IPEndpoint const &local);
+
+/// Destroy @a ssn. All transactions for the session must already be closed.
+void ssn_destroy(TSHttpSsn ssn);
+
+/** Create a transaction.
+ *
+ * @param ssn Parent session.
+ * @return A new transaction.
+ *
+ * The global transaction start hooks are @b not invoked, use @c hook_invoke for that.
+ */
+TSHttpTxn txn_create(TSHttpSsn ssn);
+
+/** Close a transaction.
+ *
+ * @param txn Transaction.
+ *
+ * This invokes the transaction close hooks and then destroys @a txn.
+ */
+void txn_close(TSHttpTxn txn);
+
+/** Set a transaction header from text.
+ *
+ * @param txn Transaction.
+ * @param which Header to set.
+ * @param text HTTP/1 header text - first line followed by fields.
+ * @return @c true on success, @c false if @a text couldn't be parsed.
+ *
+ * The header is created if it doesn't already exist, and replaced otherwise.
+ */
+bool hdr_assign(TSHttpTxn txn, Hdr which, swoc::TextView text);
+
+/** Invoke the hooks for @a id on @a txn.
+ *
+ * @param txn Transaction.
+ * @param id Hook.
+ * @return The event passed to @c TSHttpTxnReenable by the last callback.
+ *
+ * Global hooks are invoked first, followed by transaction local hooks. If a callback reenables
+ * with @c TS_EVENT_HTTP_ERROR the remaining callbacks are skipped.
+ *
+ * Headers are created as the corresponding hook is reached, if not already set. The proxy request
+ * is a copy of the client request and the proxy response a copy of the upstream response, or a
+ * 200 response if there is no upstream response.
+ */
+TSEvent hook_invoke(TSHttpTxn txn, TSHttpHookID id);
+
+/** Set up remap information for @a txn.
+ *
+ * @param txn Transaction.
+ * @param from Remap rule source URL.
+ * @param to Remap rule target URL.
+ * @return Remap information suitable for passing to @c TSRemapDoRemap.
+ *
+ * The returned object is valid until @a txn is closed.
+ */
+TSRemapRequestInfo *remap_info(TSHttpTxn txn, swoc::TextView from, swoc::TextView to);
+
+/** Invoke lifecycle hooks.
+ *
+ * @param id Lifecycle hook.
+ * @param data Event data.
+ */
+void lifecycle_invoke(TSLifecycleHookID id, void *data);
+
+/** Run scheduled tasks.
+ *
+ * @return The number of tasks run.
+ *
+ * All pending one shot tasks are run, and periodic tasks are run once.
+ */
+unsigned task_run();
+
+/// @return The current value of the transaction status (as set by @c TSHttpTxnStatusSet).
+TSHttpStatus txn_status(TSHttpTxn txn);
+
+/// @return The upstream address set for @a txn, if any.
+swoc::IPEndpoint txn_upstream_addr(TSHttpTxn txn);
+
+} // namespace ts_mock